@@ -5,6 +5,13 @@
 #include "driver/i2c.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "i2c_scanner.h"
+
+// Build as a standalone app (flash this component on its own) instead of a library
+#ifndef I2C_SCANNER_STANDALONE
+#define I2C_SCANNER_STANDALONE 0
+#endif
 
 static const char *TAG = "I2C_SCANNER";
 
@@ -14,44 +21,77 @@ static const char *TAG = "I2C_SCANNER";
 #define I2C_MASTER_NUM I2C_NUM_0
 #define I2C_MASTER_FREQ_HZ 100000
 
-// I2C master initialization
-static void i2c_master_init(void)
+// Valid 7-bit address range (0x00-0x07 and 0x78-0x7F are reserved)
+#define I2C_ADDR_FIRST 0x08
+#define I2C_ADDR_LAST  0x77
+
+// Benchmark transactions: one full SSD1306 page (control byte + 128 data bytes)
+#define I2C_DIAG_PAYLOAD 128
+#define I2C_DIAG_TIMEOUT_MS 50
+
+// Reconfigure the master clock
+static esp_err_t i2c_set_clock(const i2c_diag_config_t *config, uint32_t clk_hz)
 {
     i2c_config_t conf = {
         .mode = I2C_MODE_MASTER,
-        .sda_io_num = I2C_MASTER_SDA_IO,
-        .scl_io_num = I2C_MASTER_SCL_IO,
+        .sda_io_num = config->sda_io_num,
+        .scl_io_num = config->scl_io_num,
         .sda_pullup_en = GPIO_PULLUP_ENABLE,
         .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = I2C_MASTER_FREQ_HZ,
+        .master.clk_speed = clk_hz,
     };
-    i2c_param_config(I2C_MASTER_NUM, &conf);
-    i2c_driver_install(I2C_MASTER_NUM, conf.mode, 0, 0, 0);
+    return i2c_param_config(config->port, &conf);
+}
+
+// Probe one address with an empty write
+static esp_err_t i2c_probe(i2c_port_t port, uint8_t addr, TickType_t timeout)
+{
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_stop(cmd);
+    esp_err_t ret = i2c_master_cmd_begin(port, cmd, timeout);
+    i2c_cmd_link_delete(cmd);
+    return ret;
 }
 
-// Scan for I2C devices
-static void i2c_scanner(void)
+esp_err_t i2c_scanner_scan(i2c_port_t port, uint8_t devices[16], uint8_t *count)
+{
+    const TickType_t timeout = pdMS_TO_TICKS(I2C_SCAN_TIMEOUT_MS) ? pdMS_TO_TICKS(I2C_SCAN_TIMEOUT_MS) : 1;
+    esp_err_t result = ESP_OK;
+
+    memset(devices, 0, 16);
+    *count = 0;
+
+    for (int addr = I2C_ADDR_FIRST; addr <= I2C_ADDR_LAST; addr++) {
+        esp_err_t ret = i2c_probe(port, addr, timeout);
+        if (ret == ESP_OK) {
+            devices[addr >> 3] |= 1u << (addr & 7);
+            (*count)++;
+        } else if (ret == ESP_ERR_TIMEOUT) {
+            // A stuck bus times out on every address; no point continuing
+            result = ESP_ERR_TIMEOUT;
+            break;
+        }
+    }
+
+    return result;
+}
+
+bool i2c_scanner_has_device(const uint8_t devices[16], uint8_t addr)
+{
+    return addr < 128 && (devices[addr >> 3] & (1u << (addr & 7)));
+}
+
+void i2c_scanner_print(const uint8_t devices[16])
 {
-    ESP_LOGI(TAG, "Starting I2C Scanner...");
-    ESP_LOGI(TAG, "Scanning I2C bus on pins SDA:%d, SCL:%d", I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO);
-    
     printf("     0  1  2  3  4  5  6  7  8  9  a  b  c  d  e  f\n");
-    
+
     for (int i = 0; i < 128; i += 16) {
         printf("%02x: ", i);
         for (int j = 0; j < 16; j++) {
-            fflush(stdout);
-            
             int addr = i + j;
-            i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-            i2c_master_start(cmd);
-            i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
-            i2c_master_stop(cmd);
-            
-            esp_err_t ret = i2c_master_cmd_begin(I2C_MASTER_NUM, cmd, pdMS_TO_TICKS(100));
-            i2c_cmd_link_delete(cmd);
-            
-            if (ret == ESP_OK) {
+            if (i2c_scanner_has_device(devices, addr)) {
                 printf("%02x ", addr);
             } else {
                 printf("-- ");
@@ -59,15 +99,203 @@ static void i2c_scanner(void)
         }
         printf("\n");
     }
-    
-    ESP_LOGI(TAG, "I2C Scanner completed!");
+}
+
+// Insertion sort for the small latency sample set
+static void sort_u32(uint32_t *values, int count)
+{
+    for (int i = 1; i < count; i++) {
+        uint32_t v = values[i];
+        int j = i - 1;
+        while (j >= 0 && values[j] > v) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = v;
+    }
+}
+
+// Nearest-rank percentile of sorted samples
+static uint32_t percentile(const uint32_t *sorted, int count, int pct)
+{
+    if (count == 0) {
+        return 0;
+    }
+    int rank = (pct * count + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Sustained write benchmark at the current clock speed
+static void i2c_diag_measure(const i2c_diag_config_t *config, i2c_diag_speed_t *result)
+{
+    static uint8_t payload[1 + I2C_DIAG_PAYLOAD];
+    static uint32_t latency[I2C_DIAG_LATENCY_SAMPLES];
+    const TickType_t timeout = pdMS_TO_TICKS(I2C_DIAG_TIMEOUT_MS);
+    // SSD1306: full-screen column/page window so data writes wrap through display RAM
+    const uint8_t window[] = { 0x00, 0x21, 0, 127, 0x22, 0, 7 };
+    uint64_t ok_bytes = 0;
+    uint64_t ok_us = 0;
+    int samples = 0;
+
+    payload[0] = 0x40;  // Data mode, zeroed pixels
+    i2c_master_write_to_device(config->port, config->device_addr, window, sizeof(window), timeout);
+
+    for (int i = 0; i < I2C_DIAG_LATENCY_SAMPLES; i++) {
+        int64_t start = esp_timer_get_time();
+        esp_err_t ret = i2c_master_write_to_device(config->port, config->device_addr,
+                                                   payload, sizeof(payload), timeout);
+        uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+        result->transactions++;
+        if (ret == ESP_OK) {
+            latency[samples++] = elapsed;
+            ok_bytes += sizeof(payload);
+            ok_us += elapsed;
+        } else if (ret == ESP_ERR_TIMEOUT) {
+            result->timeouts++;
+        } else {
+            result->nacks++;
+        }
+    }
+
+    sort_u32(latency, samples);
+    result->bytes_per_s = ok_us ? (uint32_t)(ok_bytes * 1000000 / ok_us) : 0;
+    result->latency_p50_us = percentile(latency, samples, 50);
+    result->latency_p90_us = percentile(latency, samples, 90);
+    result->latency_p99_us = percentile(latency, samples, 99);
+    result->latency_max_us = samples ? latency[samples - 1] : 0;
+}
+
+esp_err_t i2c_diag_run(const i2c_diag_config_t *config, i2c_diag_report_t *report)
+{
+    memset(report, 0, sizeof(*report));
+
+    if (config->speed_count <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Fast scan at the lowest (safest) speed
+    i2c_set_clock(config, config->speeds_hz[0]);
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = i2c_scanner_scan(config->port, report->devices, &report->device_count);
+    report->scan_us = (uint32_t)(esp_timer_get_time() - start);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Bus scan failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    if (!i2c_scanner_has_device(report->devices, config->device_addr)) {
+        ESP_LOGW(TAG, "No device at 0x%02x, skipping bus speed tests", config->device_addr);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    for (int i = 0; i < config->speed_count && i < I2C_DIAG_MAX_SPEEDS; i++) {
+        i2c_diag_speed_t *result = &report->speeds[report->speed_count++];
+        result->clk_hz = config->speeds_hz[i];
+
+        if (i2c_set_clock(config, result->clk_hz) != ESP_OK) {
+            ESP_LOGW(TAG, "Clock %u Hz not supported", (unsigned)result->clk_hz);
+            continue;
+        }
+        i2c_diag_measure(config, result);
+
+        if (result->transactions > 0 && result->nacks == 0 && result->timeouts == 0) {
+            report->best_clk_hz = result->clk_hz;
+        }
+    }
+
+    i2c_set_clock(config, report->best_clk_hz ? report->best_clk_hz : config->speeds_hz[0]);
+    return ESP_OK;
+}
+
+void i2c_diag_log(const i2c_diag_report_t *report)
+{
+    ESP_LOGI(TAG, "Scan: %d device(s) in %u us", report->device_count, (unsigned)report->scan_us);
+
+    for (int i = 0; i < report->speed_count; i++) {
+        const i2c_diag_speed_t *s = &report->speeds[i];
+        ESP_LOGI(TAG, "%4u kHz: %6u B/s, latency p50/p90/p99/max %u/%u/%u/%u us, %u/%u nack/timeout of %u",
+                 (unsigned)(s->clk_hz / 1000), (unsigned)s->bytes_per_s,
+                 (unsigned)s->latency_p50_us, (unsigned)s->latency_p90_us,
+                 (unsigned)s->latency_p99_us, (unsigned)s->latency_max_us,
+                 s->nacks, s->timeouts, s->transactions);
+    }
+
+    ESP_LOGI(TAG, "Selected bus speed: %u kHz", (unsigned)(report->best_clk_hz / 1000));
+}
+
+int i2c_diag_format_json(const i2c_diag_report_t *report, char *buf, size_t len)
+{
+    int pos = snprintf(buf, len, "{\"devices\":%d,\"scan_us\":%u,\"clk_hz\":%u,\"speeds\":[",
+                       report->device_count, (unsigned)report->scan_us, (unsigned)report->best_clk_hz);
+
+    for (int i = 0; i < report->speed_count && pos < (int)len; i++) {
+        const i2c_diag_speed_t *s = &report->speeds[i];
+        pos += snprintf(buf + pos, len - pos,
+                        "%s{\"hz\":%u,\"Bps\":%u,\"p50\":%u,\"p90\":%u,\"p99\":%u,\"max\":%u,\"n\":%u,\"nack\":%u,\"to\":%u}",
+                        i ? "," : "", (unsigned)s->clk_hz, (unsigned)s->bytes_per_s,
+                        (unsigned)s->latency_p50_us, (unsigned)s->latency_p90_us,
+                        (unsigned)s->latency_p99_us, (unsigned)s->latency_max_us,
+                        s->transactions, s->nacks, s->timeouts);
+    }
+    if (pos < (int)len) {
+        pos += snprintf(buf + pos, len - pos, "]}");
+    }
+    return pos < (int)len ? pos : (int)len - 1;
+}
+
+#if I2C_SCANNER_STANDALONE
+
+// Clock speeds tried by the standalone diagnostic, up to the SSD1306's rated 400 kHz
+// unless I2C_DIAG_OVERCLOCK is set (see main.c)
+#ifndef I2C_DIAG_OVERCLOCK
+#define I2C_DIAG_OVERCLOCK 0
+#endif
+
+static const uint32_t diag_speeds[] = {
+    100000, 400000,
+    #if I2C_DIAG_OVERCLOCK
+    800000, 1000000,
+    #endif
+};
+
+// I2C master initialization
+static void i2c_master_init(void)
+{
+    i2c_config_t conf = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = I2C_MASTER_SDA_IO,
+        .scl_io_num = I2C_MASTER_SCL_IO,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = I2C_MASTER_FREQ_HZ,
+    };
+    i2c_param_config(I2C_MASTER_NUM, &conf);
+    i2c_driver_install(I2C_MASTER_NUM, conf.mode, 0, 0, 0);
 }
 
 // Main task
 static void scanner_task(void *pvParameter)
 {
+    static i2c_diag_report_t report;
+    const i2c_diag_config_t config = {
+        .port = I2C_MASTER_NUM,
+        .sda_io_num = I2C_MASTER_SDA_IO,
+        .scl_io_num = I2C_MASTER_SCL_IO,
+        .device_addr = 0x3C,
+        .speeds_hz = diag_speeds,
+        .speed_count = sizeof(diag_speeds) / sizeof(diag_speeds[0]),
+    };
+
     while(1) {
-        i2c_scanner();
+        ESP_LOGI(TAG, "Starting I2C Scanner...");
+        ESP_LOGI(TAG, "Scanning I2C bus on pins SDA:%d, SCL:%d", I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO);
+
+        i2c_diag_run(&config, &report);
+        i2c_scanner_print(report.devices);
+        i2c_diag_log(&report);
+
+        ESP_LOGI(TAG, "I2C Scanner completed!");
         ESP_LOGI(TAG, "Waiting 10 seconds before next scan...");
         vTaskDelay(pdMS_TO_TICKS(10000));
     }
@@ -77,14 +305,16 @@ void app_main(void)
 {
     ESP_LOGI(TAG, "I2C Scanner for ESP32 Bitcoin Price Tracker");
     ESP_LOGI(TAG, "This will help you test your OLED display connection");
-    
+
     // Initialize I2C
     i2c_master_init();
     ESP_LOGI(TAG, "I2C initialized successfully");
-    
+
     // Create scanner task
-    xTaskCreate(scanner_task, "scanner_task", 2048, NULL, 5, NULL);
-    
+    xTaskCreate(scanner_task, "scanner_task", 4096, NULL, 5, NULL);
+
     ESP_LOGI(TAG, "I2C Scanner task created. Check serial output for results.");
     ESP_LOGI(TAG, "Expected to see device at address 0x3C (SSD1306 OLED)");
-} 
\ No newline at end of file
+}
+
+#endif // I2C_SCANNER_STANDALONE
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/i2c.h"
+#include "esp_err.h"
+
+// I2C bus diagnostics: fast address scan plus per-clock throughput, latency and
+// error measurements against an SSD1306, used to pick the bus speed at boot.
+
+#define I2C_DIAG_MAX_SPEEDS 4
+#define I2C_DIAG_LATENCY_SAMPLES 64   // Timed transactions per clock speed
+#define I2C_SCAN_TIMEOUT_MS 5         // Per-probe timeout for the fast scan
+
+typedef struct {
+    i2c_port_t port;
+    int sda_io_num;                   // Pins, needed to reconfigure the clock
+    int scl_io_num;
+    uint8_t device_addr;              // Device used for throughput tests (SSD1306)
+    const uint32_t *speeds_hz;        // Clock speeds to test, ascending
+    int speed_count;
+} i2c_diag_config_t;
+
+typedef struct {
+    uint32_t clk_hz;
+    uint32_t bytes_per_s;             // Sustained write throughput
+    uint32_t latency_p50_us;          // Per-transaction latency percentiles
+    uint32_t latency_p90_us;
+    uint32_t latency_p99_us;
+    uint32_t latency_max_us;
+    uint16_t transactions;
+    uint16_t nacks;
+    uint16_t timeouts;
+} i2c_diag_speed_t;
+
+typedef struct {
+    uint8_t devices[16];              // Bitmap of responding 7-bit addresses
+    uint8_t device_count;
+    uint32_t scan_us;
+    i2c_diag_speed_t speeds[I2C_DIAG_MAX_SPEEDS];
+    int speed_count;
+    uint32_t best_clk_hz;             // Fastest speed with no errors, 0 if none
+} i2c_diag_report_t;
+
+// Probe 0x08-0x77 with a short timeout and fill a 128-bit address bitmap
+esp_err_t i2c_scanner_scan(i2c_port_t port, uint8_t devices[16], uint8_t *count);
+bool i2c_scanner_has_device(const uint8_t devices[16], uint8_t addr);
+void i2c_scanner_print(const uint8_t devices[16]);
+
+// Run the scan and, if the device responds, a write benchmark at each clock speed.
+// The bus must be installed as master; it is left at the best speed found (or the
+// first configured speed if none were error free).
+esp_err_t i2c_diag_run(const i2c_diag_config_t *config, i2c_diag_report_t *report);
+void i2c_diag_log(const i2c_diag_report_t *report);
+
+// Compact JSON object for the metrics output. Returns the length written.
+int i2c_diag_format_json(const i2c_diag_report_t *report, char *buf, size_t len);
@@ -0,0 +1,196 @@
+#include <string.h>
+#include "alerts.h"
+
+// Q16 fixed-point one
+#define Q16_ONE 65536
+
+// Blink patterns, one bit per 100ms step
+static const uint16_t led_patterns[ALERT_LED_PATTERN_COUNT] = {
+    [ALERT_LED_NONE]   = 0x0000,
+    [ALERT_LED_SLOW]   = 0x00FF,  // 800ms on, 800ms off
+    [ALERT_LED_FAST]   = 0x5555,  // 100ms on, 100ms off
+    [ALERT_LED_DOUBLE] = 0x0005,  // Two short blinks, then pause
+};
+
+uint16_t alert_led_pattern_bits(uint8_t pattern)
+{
+    return pattern < ALERT_LED_PATTERN_COUNT ? led_patterns[pattern] : 0;
+}
+
+// EMA smoothing factor 2 / (N + 1) in Q16
+static int32_t ema_alpha_q16(uint16_t period)
+{
+    return (int32_t)((2 * Q16_ONE) / ((int32_t)period + 1));
+}
+
+// ema += (price - ema) * alpha, split so the product cannot overflow int64
+static price_t ema_step(price_t ema, price_t price, int32_t alpha)
+{
+    int64_t diff = price - ema;
+    return ema + (diff / Q16_ONE) * alpha + ((diff % Q16_ONE) * alpha) / Q16_ONE;
+}
+
+// Relative move from ref to price in basis points, clamped to int32
+static int32_t move_bp(price_t ref, price_t price)
+{
+    int64_t diff = price - ref;
+    int64_t bp;
+
+    if (ref <= 0) {
+        return 0;
+    }
+    if (diff > INT64_MAX / 10000 || diff < -(INT64_MAX / 10000)) {
+        bp = diff / (ref / 10000 > 0 ? ref / 10000 : 1);
+    } else {
+        bp = diff * 10000 / ref;
+    }
+    if (bp > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (bp < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)bp;
+}
+
+static bool rule_is_valid(const alert_rule_t *rule)
+{
+    switch (rule->type) {
+        case ALERT_RULE_PRICE_ABOVE:
+        case ALERT_RULE_PRICE_BELOW:
+            return rule->level > 0;
+        case ALERT_RULE_PCT_MOVE:
+            return rule->level != 0 && rule->window_s > 0;
+        case ALERT_RULE_EMA_CROSS:
+            return rule->fast > 0 && rule->fast < rule->slow;
+        default:
+            return false;
+    }
+}
+
+uint32_t alert_history_span_s(uint32_t interval_s)
+{
+    uint64_t span = (uint64_t)(ALERT_HISTORY_LEN - 1) * interval_s;
+    return span > UINT32_MAX ? UINT32_MAX : (uint32_t)span;
+}
+
+bool alert_rule_fits_history(const alert_rule_t *rule, uint32_t interval_s)
+{
+    return rule->type != ALERT_RULE_PCT_MOVE || rule->window_s <= alert_history_span_s(interval_s);
+}
+
+int alert_engine_compile(alert_engine_t *engine, const alert_rule_t *rules, size_t count)
+{
+    memset(engine, 0, sizeof(*engine));
+
+    for (size_t i = 0; i < count && engine->slot_count < ALERT_MAX_RULES; i++) {
+        const alert_rule_t *rule = &rules[i];
+
+        if (!(rule->flags & ALERT_FLAG_ENABLED) || !rule_is_valid(rule)) {
+            continue;
+        }
+
+        alert_slot_t *slot = &engine->slots[engine->slot_count++];
+        slot->type = rule->type;
+        slot->led_pattern = rule->led_pattern < ALERT_LED_PATTERN_COUNT ? rule->led_pattern : ALERT_LED_NONE;
+        slot->flags = rule->flags;
+        slot->rule_index = (uint8_t)i;
+        slot->level = rule->level;
+        slot->window_s = rule->window_s;
+        if (rule->type == ALERT_RULE_EMA_CROSS) {
+            slot->alpha_fast = ema_alpha_q16(rule->fast);
+            slot->alpha_slow = ema_alpha_q16(rule->slow);
+        }
+    }
+
+    return engine->slot_count;
+}
+
+// Edge-triggered latch: true only on the sample where the condition becomes true
+static bool latch(alert_slot_t *slot, bool condition)
+{
+    bool fire = condition && !slot->state;
+    slot->state = condition ? 1 : 0;
+    return fire;
+}
+
+int alert_engine_update(alert_engine_t *engine, uint32_t now_s, price_t price,
+                        alert_event_t *events, size_t max_events)
+{
+    const bool first = (engine->head == 0);
+    const uint32_t newest = engine->head;
+    const uint32_t oldest = newest >= ALERT_HISTORY_LEN ? newest - (ALERT_HISTORY_LEN - 1) : 0;
+    int fired = 0;
+
+    // Append sample to the shared history ring
+    engine->history[newest % ALERT_HISTORY_LEN].t = now_s;
+    engine->history[newest % ALERT_HISTORY_LEN].price = price;
+    engine->head++;
+
+    for (uint8_t i = 0; i < engine->slot_count; i++) {
+        alert_slot_t *slot = &engine->slots[i];
+        bool fire = false;
+        int32_t value = 0;
+
+        switch (slot->type) {
+            case ALERT_RULE_PRICE_ABOVE:
+                fire = latch(slot, price >= slot->level);
+                break;
+
+            case ALERT_RULE_PRICE_BELOW:
+                fire = latch(slot, price <= slot->level);
+                break;
+
+            case ALERT_RULE_PCT_MOVE: {
+                // Advance this rule's window start; each sample is passed at most once
+                uint32_t cutoff = now_s > slot->window_s ? now_s - slot->window_s : 0;
+                if (slot->tail < oldest) {
+                    slot->tail = oldest;
+                }
+                while (slot->tail < newest &&
+                       engine->history[slot->tail % ALERT_HISTORY_LEN].t < cutoff) {
+                    slot->tail++;
+                }
+                value = move_bp(engine->history[slot->tail % ALERT_HISTORY_LEN].price, price);
+                fire = latch(slot, slot->level > 0 ? value >= slot->level : value <= slot->level);
+                break;
+            }
+
+            case ALERT_RULE_EMA_CROSS: {
+                if (first) {
+                    slot->ema_fast = price;
+                    slot->ema_slow = price;
+                    break;
+                }
+                slot->ema_fast = ema_step(slot->ema_fast, price, slot->alpha_fast);
+                slot->ema_slow = ema_step(slot->ema_slow, price, slot->alpha_slow);
+
+                int8_t side = (slot->ema_fast > slot->ema_slow) - (slot->ema_fast < slot->ema_slow);
+                if (side != 0) {
+                    if (slot->state != 0 && side != slot->state &&
+                        (slot->level == 0 || (slot->level > 0) == (side > 0))) {
+                        fire = true;
+                        value = side;
+                    }
+                    slot->state = side;
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        if (fire && (size_t)fired < max_events) {
+            alert_event_t *event = &events[fired++];
+            event->rule_index = slot->rule_index;
+            event->type = slot->type;
+            event->led_pattern = slot->led_pattern;
+            event->flags = slot->flags;
+            event->price = price;
+            event->value = value;
+        }
+    }
+
+    return fired;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "price.h"
+
+// Alert engine limits
+#define ALERT_MAX_RULES 16
+// Samples kept for windowed rules. A PCT_MOVE window must fit in ALERT_HISTORY_LEN - 1
+// fetch intervals (~21h at 10 min fetches, ~2h at 1 min), see alert_rule_fits_history().
+#define ALERT_HISTORY_LEN 128
+#define ALERT_MAX_EVENTS ALERT_MAX_RULES
+
+// Rule types
+typedef enum {
+    ALERT_RULE_PRICE_ABOVE = 0,  // price >= level
+    ALERT_RULE_PRICE_BELOW = 1,  // price <= level
+    ALERT_RULE_PCT_MOVE = 2,     // move over window_s reaches level bp (> 0 rise, < 0 drop)
+    ALERT_RULE_EMA_CROSS = 3,    // EMA(fast) crosses EMA(slow) (level > 0 up only, < 0 down only, 0 = both)
+    ALERT_RULE_TYPE_COUNT
+} alert_rule_type_t;
+
+// LED blink patterns (16 steps of 100ms, LSB first)
+typedef enum {
+    ALERT_LED_NONE = 0,
+    ALERT_LED_SLOW = 1,
+    ALERT_LED_FAST = 2,
+    ALERT_LED_DOUBLE = 3,
+    ALERT_LED_PATTERN_COUNT
+} alert_led_pattern_t;
+
+// Rule flags
+#define ALERT_FLAG_ENABLED 0x01
+#define ALERT_FLAG_BANNER  0x02  // Show an on-screen banner when the rule fires
+
+// Stored rule format (NVS blob element). Packed so the blob layout is stable.
+typedef struct __attribute__((packed)) {
+    uint8_t type;         // alert_rule_type_t
+    uint8_t flags;        // ALERT_FLAG_*
+    uint8_t led_pattern;  // alert_led_pattern_t
+    uint8_t reserved;
+    int64_t level;        // price_t for ABOVE/BELOW, bp for PCT_MOVE, direction for EMA_CROSS
+    uint32_t window_s;    // PCT_MOVE window length in seconds
+    uint16_t fast;        // EMA_CROSS fast period (samples)
+    uint16_t slow;        // EMA_CROSS slow period (samples)
+} alert_rule_t;
+
+// Compiled rule slot: parameters pre-converted for the integer hot loop plus per-rule state
+typedef struct {
+    uint8_t type;
+    uint8_t led_pattern;
+    uint8_t flags;
+    int8_t state;         // Latched condition (threshold/move) or last EMA side (-1/0/+1)
+    uint8_t rule_index;   // Index in the source rule list
+    uint32_t window_s;
+    uint32_t tail;        // PCT_MOVE: sequence number of the oldest sample inside the window
+    int64_t level;
+    int32_t alpha_fast;   // EMA smoothing factors in Q16
+    int32_t alpha_slow;
+    price_t ema_fast;
+    price_t ema_slow;
+} alert_slot_t;
+
+typedef struct {
+    uint32_t t;           // Sample time in seconds
+    price_t price;
+} alert_sample_t;
+
+typedef struct {
+    alert_slot_t slots[ALERT_MAX_RULES];
+    uint8_t slot_count;
+    alert_sample_t history[ALERT_HISTORY_LEN];
+    uint32_t head;        // Sequence number of the next sample to write
+} alert_engine_t;
+
+// Fired alert
+typedef struct {
+    uint8_t rule_index;
+    uint8_t type;
+    uint8_t led_pattern;
+    uint8_t flags;
+    price_t price;        // Price that triggered the alert
+    int32_t value;        // PCT_MOVE: observed move in bp, EMA_CROSS: +1/-1
+} alert_event_t;
+
+// Compile stored rules into the engine table, resetting all state.
+// Disabled or malformed rules are skipped. Returns the number of compiled rules.
+int alert_engine_compile(alert_engine_t *engine, const alert_rule_t *rules, size_t count);
+
+// Feed one sample. Runs in O(rules) amortized, never rescans history.
+// Returns the number of events written to events (at most max_events).
+int alert_engine_update(alert_engine_t *engine, uint32_t now_s, price_t price,
+                        alert_event_t *events, size_t max_events);
+
+// Time covered by the sample history when samples arrive every interval_s seconds
+uint32_t alert_history_span_s(uint32_t interval_s);
+
+// False for a PCT_MOVE rule whose window is longer than the history covers at this
+// sample interval; such a rule would compare against the oldest sample it still has.
+bool alert_rule_fits_history(const alert_rule_t *rule, uint32_t interval_s);
+
+// LED pattern bitmask for a pattern id (bit n = LED state in step n)
+uint16_t alert_led_pattern_bits(uint8_t pattern);
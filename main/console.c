@@ -0,0 +1,368 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+#include "price.h"
+#include "alerts.h"
+#include "currency.h"
+#include "settings.h"
+#include "console.h"
+
+#define CONSOLE_POLL_MS 50
+
+static StackType_t console_task_stack[CONSOLE_TASK_STACK_SIZE];
+static StaticTask_t console_task_tcb;
+static console_change_fn change_callback;
+
+static const char *const rule_type_names[ALERT_RULE_TYPE_COUNT] = {
+    [ALERT_RULE_PRICE_ABOVE] = "above",
+    [ALERT_RULE_PRICE_BELOW] = "below",
+    [ALERT_RULE_PCT_MOVE] = "move",
+    [ALERT_RULE_EMA_CROSS] = "ema",
+};
+
+static const char *const led_pattern_names[ALERT_LED_PATTERN_COUNT] = {
+    [ALERT_LED_NONE] = "none",
+    [ALERT_LED_SLOW] = "slow",
+    [ALERT_LED_FAST] = "fast",
+    [ALERT_LED_DOUBLE] = "double",
+};
+
+static void console_help(void)
+{
+    printf("Commands:\n"
+           "  show                          Print settings\n"
+           "  set ssid <name>               WiFi SSID (applied after reboot)\n"
+           "  set password <secret>         WiFi password (applied after reboot)\n"
+           "  set asset <id> [symbol]       CoinGecko coin id and banner label\n"
+           "  set currencies <a,b,c>        Currency list, first one drives alerts\n"
+           "  set fetch <seconds>           Fetch interval\n"
+           "  set metrics <seconds>         METRICS log interval\n"
+           "  rules                         List alert rules\n"
+           "  rule add above|below <price>  Price threshold\n"
+           "  rule add move <pct> <minutes> Move within a window (negative = drop)\n"
+           "  rule add ema <fast> <slow>    EMA crossover\n"
+           "  rule del <n> | rule clear     Remove rules\n"
+           "  save                          Write pending changes now\n"
+           "  reboot                        Save and restart\n");
+}
+
+// Split off the next space separated token, NULL at end of line
+static char *next_token(char **p)
+{
+    while (**p == ' ') {
+        (*p)++;
+    }
+    if (**p == '\0') {
+        return NULL;
+    }
+    char *token = *p;
+    while (**p && **p != ' ') {
+        (*p)++;
+    }
+    if (**p) {
+        *(*p)++ = '\0';
+    }
+    return token;
+}
+
+static bool parse_uint(const char *s, uint32_t min, uint32_t max, uint32_t *out)
+{
+    char *end;
+    unsigned long value = s ? strtoul(s, &end, 10) : 0;
+    if (!s || *end != '\0' || value < min || value > max) {
+        return false;
+    }
+    *out = (uint32_t)value;
+    return true;
+}
+
+static void console_print_rule(int index, const alert_rule_t *rule, uint32_t fetch_interval_s)
+{
+    char value[24] = "";
+
+    switch (rule->type) {
+        case ALERT_RULE_PRICE_ABOVE:
+        case ALERT_RULE_PRICE_BELOW:
+            price_format_decimal(value, sizeof(value), rule->level, 2, 0, '.');
+            break;
+        case ALERT_RULE_PCT_MOVE: {
+            size_t n = price_format_percent(value, sizeof(value), (bp_t)rule->level);
+            snprintf(value + n, sizeof(value) - n, " in %um", (unsigned)(rule->window_s / 60));
+            break;
+        }
+        case ALERT_RULE_EMA_CROSS:
+            snprintf(value, sizeof(value), "%u/%u", rule->fast, rule->slow);
+            break;
+        default:
+            break;
+    }
+
+    printf("  %2d: %-5s %-16s led %-6s%s%s%s\n", index,
+           rule->type < ALERT_RULE_TYPE_COUNT ? rule_type_names[rule->type] : "?", value,
+           rule->led_pattern < ALERT_LED_PATTERN_COUNT ? led_pattern_names[rule->led_pattern] : "?",
+           rule->flags & ALERT_FLAG_BANNER ? " banner" : "",
+           rule->flags & ALERT_FLAG_ENABLED ? "" : " (disabled)",
+           alert_rule_fits_history(rule, fetch_interval_s) ? "" : " (window exceeds history)");
+}
+
+static void console_show(void)
+{
+    const settings_t *s = settings_lock();
+
+    printf("ssid       %s\n", s->wifi_ssid);
+    printf("password   %s\n", s->wifi_password[0] ? "********" : "(none)");
+    printf("asset      %s (%s)\n", s->asset_id, s->asset_symbol);
+    printf("currencies %s (showing #%d)\n", s->currencies, s->display_currency);
+    printf("fetch      %us\n", (unsigned)s->fetch_interval_s);
+    printf("metrics    %us\n", (unsigned)s->metrics_interval_s);
+    printf("rules      %d\n", s->alert_rule_count);
+
+    settings_unlock(false);
+}
+
+static void console_rules(void)
+{
+    const settings_t *s = settings_lock();
+
+    for (int i = 0; i < s->alert_rule_count; i++) {
+        console_print_rule(i, &s->alert_rules[i], s->fetch_interval_s);
+    }
+    if (s->alert_rule_count == 0) {
+        printf("  (no rules)\n");
+    }
+
+    settings_unlock(false);
+}
+
+// "set <key> <value>". Returns the kind of runtime change to apply.
+static console_change_t console_set(char *args)
+{
+    char *key = next_token(&args);
+    while (*args == ' ') {
+        args++;
+    }
+    char *value = args;  // Rest of the line, may contain spaces (SSID)
+
+    if (!key || *value == '\0') {
+        printf("usage: set <key> <value>\n");
+        return CONSOLE_CHANGE_NONE;
+    }
+
+    settings_t *s = settings_lock();
+    bool changed = true;
+    bool runtime = true;
+    console_change_t change = CONSOLE_CHANGE_NONE;
+    uint32_t seconds;
+
+    if (strcmp(key, "ssid") == 0 && strlen(value) < sizeof(s->wifi_ssid)) {
+        strcpy(s->wifi_ssid, value);
+        runtime = false;
+    } else if (strcmp(key, "password") == 0 && strlen(value) < sizeof(s->wifi_password)) {
+        strcpy(s->wifi_password, value);
+        runtime = false;
+    } else if (strcmp(key, "asset") == 0) {
+        char *id = next_token(&value);
+        char *symbol = next_token(&value);
+        if (strlen(id) < sizeof(s->asset_id) && (!symbol || strlen(symbol) < sizeof(s->asset_symbol))) {
+            strcpy(s->asset_id, id);
+            strcpy(s->asset_symbol, symbol ? symbol : "");
+            change = CONSOLE_CHANGE_FEED;
+        } else {
+            changed = false;
+        }
+    } else if (strcmp(key, "currencies") == 0 && strlen(value) < sizeof(s->currencies)) {
+        const currency_t *parsed[PRICE_TABLE_MAX_CURRENCIES];
+        if (currency_parse_list(value, parsed, PRICE_TABLE_MAX_CURRENCIES) > 0) {
+            strcpy(s->currencies, value);
+            s->display_currency = 0;
+            change = CONSOLE_CHANGE_FEED;
+        } else {
+            changed = false;
+        }
+    } else if (strcmp(key, "fetch") == 0 && parse_uint(value, 60, 86400, &seconds)) {
+        // Move windows must stay inside the sample history at the new interval
+        for (int i = 0; i < s->alert_rule_count && changed; i++) {
+            if (!alert_rule_fits_history(&s->alert_rules[i], seconds)) {
+                printf("rule %d window exceeds the %um history at %us fetches\n",
+                       i, (unsigned)(alert_history_span_s(seconds) / 60), (unsigned)seconds);
+                changed = false;
+            }
+        }
+        if (changed) {
+            s->fetch_interval_s = seconds;
+        }
+    } else if (strcmp(key, "metrics") == 0 && parse_uint(value, 10, 86400, &seconds)) {
+        s->metrics_interval_s = seconds;
+    } else {
+        changed = false;
+    }
+
+    settings_unlock(changed);
+
+    if (!changed) {
+        printf("invalid setting or value: %s\n", key);
+        return CONSOLE_CHANGE_NONE;
+    }
+    printf("ok%s\n", runtime ? "" : " (reboot to apply)");
+    return change;
+}
+
+// "rule add|del|clear ...". Returns true if the rule list changed.
+static bool console_rule(char *args)
+{
+    char *verb = next_token(&args);
+    alert_rule_t rule = { .flags = ALERT_FLAG_ENABLED | ALERT_FLAG_BANNER, .led_pattern = ALERT_LED_FAST };
+    uint32_t n;
+
+    if (!verb) {
+        printf("usage: rule add|del|clear\n");
+        return false;
+    }
+
+    if (strcmp(verb, "clear") == 0) {
+        settings_t *s = settings_lock();
+        s->alert_rule_count = 0;
+        settings_unlock(true);
+        printf("ok\n");
+        return true;
+    }
+
+    if (strcmp(verb, "del") == 0) {
+        settings_t *s = settings_lock();
+        bool valid = parse_uint(next_token(&args), 0, s->alert_rule_count ? s->alert_rule_count - 1 : 0, &n) &&
+                     s->alert_rule_count > 0;
+        if (valid) {
+            memmove(&s->alert_rules[n], &s->alert_rules[n + 1],
+                    (s->alert_rule_count - n - 1) * sizeof(alert_rule_t));
+            s->alert_rule_count--;
+        }
+        settings_unlock(valid);
+        printf(valid ? "ok\n" : "invalid rule index\n");
+        return valid;
+    }
+
+    if (strcmp(verb, "add") != 0) {
+        printf("unknown rule command: %s\n", verb);
+        return false;
+    }
+
+    char *type = next_token(&args);
+    char *a = next_token(&args);
+    char *b = next_token(&args);
+    const char *end;
+    int64_t level = 0;
+    bool valid = false;
+    uint32_t fast;
+    uint32_t slow;
+
+    if (type && a && (strcmp(type, "above") == 0 || strcmp(type, "below") == 0)) {
+        rule.type = type[0] == 'a' ? ALERT_RULE_PRICE_ABOVE : ALERT_RULE_PRICE_BELOW;
+        end = fixed_parse(a, PRICE_DECIMALS, &level);
+        valid = end && *end == '\0' && level > 0 && !b;
+    } else if (type && a && strcmp(type, "move") == 0 && parse_uint(b, 1, 1440, &n)) {
+        rule.type = ALERT_RULE_PCT_MOVE;
+        rule.window_s = n * 60;
+        end = fixed_parse(a, 2, &level);
+        valid = end && *end == '\0' && level != 0 && level > -10000 && level < 100000;
+    } else if (type && strcmp(type, "ema") == 0 &&
+               parse_uint(a, 2, 1000, &fast) && parse_uint(b, 3, 1000, &slow) && fast < slow) {
+        rule.type = ALERT_RULE_EMA_CROSS;
+        rule.led_pattern = ALERT_LED_DOUBLE;
+        rule.fast = fast;
+        rule.slow = slow;
+        valid = true;
+    }
+
+    if (!valid) {
+        printf("invalid rule, see help\n");
+        return false;
+    }
+    rule.level = level;
+
+    settings_t *s = settings_lock();
+    bool fits = alert_rule_fits_history(&rule, s->fetch_interval_s);
+    uint32_t span_min = alert_history_span_s(s->fetch_interval_s) / 60;
+    bool added = fits && s->alert_rule_count < ALERT_MAX_RULES;
+    if (added) {
+        s->alert_rules[s->alert_rule_count++] = rule;
+    }
+    settings_unlock(added);
+
+    if (!fits) {
+        printf("window too long: history covers %um at the current fetch interval\n", (unsigned)span_min);
+    } else {
+        printf(added ? "ok\n" : "rule table full\n");
+    }
+    return added;
+}
+
+static void console_execute(char *line)
+{
+    char *command = next_token(&line);
+    console_change_t change = CONSOLE_CHANGE_NONE;
+
+    if (!command) {
+        return;
+    }
+
+    if (strcmp(command, "help") == 0) {
+        console_help();
+    } else if (strcmp(command, "show") == 0) {
+        console_show();
+    } else if (strcmp(command, "set") == 0) {
+        change = console_set(line);
+    } else if (strcmp(command, "rules") == 0) {
+        console_rules();
+    } else if (strcmp(command, "rule") == 0) {
+        change = console_rule(line) ? CONSOLE_CHANGE_RULES : CONSOLE_CHANGE_NONE;
+    } else if (strcmp(command, "save") == 0) {
+        printf(settings_flush() == ESP_OK ? "saved\n" : "save failed\n");
+    } else if (strcmp(command, "reboot") == 0) {
+        settings_flush();
+        esp_restart();
+    } else {
+        printf("unknown command: %s (try help)\n", command);
+    }
+
+    if (change != CONSOLE_CHANGE_NONE && change_callback) {
+        change_callback(change);
+    }
+}
+
+// Console task - polls stdin so it works on both UART and USB serial consoles
+static void console_task(void *pvParameter)
+{
+    char line[CONSOLE_LINE_MAX];
+    size_t len = 0;
+
+    while(1) {
+        int c = getchar();
+
+        if (c == EOF) {
+            vTaskDelay(pdMS_TO_TICKS(CONSOLE_POLL_MS));
+            continue;
+        }
+
+        if (c == '\r' || c == '\n') {
+            if (len > 0) {
+                line[len] = '\0';
+                console_execute(line);
+                len = 0;
+            }
+        } else if ((c == '\b' || c == 0x7F) && len > 0) {
+            len--;
+        } else if (c >= ' ' && len < sizeof(line) - 1) {
+            line[len++] = (char)c;
+        }
+    }
+}
+
+TaskHandle_t console_start(console_change_fn on_change)
+{
+    change_callback = on_change;
+    return xTaskCreateStatic(console_task, "console_task", CONSOLE_TASK_STACK_SIZE, NULL, 2,
+                             console_task_stack, &console_task_tcb);
+}
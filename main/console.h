@@ -0,0 +1,23 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Serial settings console: line commands on the monitor port edit the settings
+// store (see settings.h). Type "help" for the command list.
+#define CONSOLE_TASK_STACK_SIZE 3072
+#define CONSOLE_LINE_MAX 128
+
+// What a console edit touched, so only the affected state is rebuilt. Fetch and metrics
+// intervals are read from the settings on every check and need no notification.
+typedef enum {
+    CONSOLE_CHANGE_NONE,
+    CONSOLE_CHANGE_FEED,   // Asset or currency set: new API URL and price table
+    CONSOLE_CHANGE_RULES,  // Alert rule list
+} console_change_t;
+
+// Called from the console task after settings that take effect at runtime change
+typedef void (*console_change_fn)(console_change_t change);
+
+// Start the console task (static storage). Returns its handle.
+TaskHandle_t console_start(console_change_fn on_change);
@@ -0,0 +1,127 @@
+#include <string.h>
+#include "currency.h"
+
+// Supported currencies (symbols are glyph strings: 0x80 euro, 0x81 pound, 0x82 yen)
+static const currency_t currencies[] = {
+    { "usd", "$",    2, ',',  '.' },
+    { "eur", "\x80", 2, '.',  ',' },
+    { "gbp", "\x81", 2, ',',  '.' },
+    { "jpy", "\x82", 0, ',',  '.' },
+    { "chf", "CHF ", 2, '\'', '.' },
+    { "cad", "C$",   2, ',',  '.' },
+    { "aud", "A$",   2, ',',  '.' },
+};
+
+#define CURRENCY_COUNT (sizeof(currencies) / sizeof(currencies[0]))
+
+const currency_t *currency_find(const char *code)
+{
+    for (size_t i = 0; i < CURRENCY_COUNT; i++) {
+        if (strcmp(currencies[i].code, code) == 0) {
+            return &currencies[i];
+        }
+    }
+    return NULL;
+}
+
+size_t currency_parse_list(const char *list, const currency_t **out, size_t max)
+{
+    size_t count = 0;
+    const char *p = list;
+
+    while (*p && count < max) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        char code[sizeof(((currency_t *)0)->code)];
+
+        if (len > 0 && len < sizeof(code)) {
+            memcpy(code, p, len);
+            code[len] = '\0';
+
+            const currency_t *currency = currency_find(code);
+            bool duplicate = false;
+            for (size_t i = 0; i < count; i++) {
+                duplicate |= (out[i] == currency);
+            }
+            if (currency && !duplicate) {
+                out[count++] = currency;
+            }
+        }
+
+        if (!end) {
+            break;
+        }
+        p = end + 1;
+    }
+
+    return count;
+}
+
+void price_table_set(price_table_t *table, int asset, int currency, price_t price, bp_t change_24h)
+{
+    table->price[asset][currency] = price;
+    table->change_24h[asset][currency] = change_24h;
+    table->valid |= 1u << (asset * PRICE_TABLE_MAX_CURRENCIES + currency);
+}
+
+bool price_table_get(const price_table_t *table, int asset, int currency, price_t *price, bp_t *change_24h)
+{
+    if (!(table->valid & (1u << (asset * PRICE_TABLE_MAX_CURRENCIES + currency)))) {
+        return false;
+    }
+    *price = table->price[asset][currency];
+    *change_24h = table->change_24h[asset][currency];
+    return true;
+}
+
+bool price_table_update_from_json(price_table_t *table, const char *json, const char *asset_id, int asset,
+                                  const currency_t *const *currencies, size_t count)
+{
+    const uint32_t row_mask = ((1u << PRICE_TABLE_MAX_CURRENCIES) - 1) << (asset * PRICE_TABLE_MAX_CURRENCIES);
+    bool found = false;
+
+    table->valid &= ~row_mask;
+
+    for (size_t i = 0; i < count && i < PRICE_TABLE_MAX_CURRENCIES; i++) {
+        char change_key[sizeof(currencies[i]->code) + sizeof("_24h_change")];
+        int64_t price;
+        int64_t change;
+
+        strcpy(change_key, currencies[i]->code);
+        strcat(change_key, "_24h_change");
+
+        if (json_extract_fixed(json, asset_id, currencies[i]->code, PRICE_DECIMALS, &price) == 0) {
+            if (json_extract_fixed(json, asset_id, change_key, 2, &change) != 0) {
+                change = 0;
+            }
+            price_table_set(table, asset, (int)i, price, (bp_t)change);
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+size_t currency_format_price(char *out, size_t len, price_t price, const currency_t *currency)
+{
+    const int decimals = price_display_decimals(price, currency->decimals);
+    size_t pos = 0;
+
+    if (price < 0) {
+        if (len < 2) {
+            return 0;
+        }
+        out[pos++] = '-';
+        price = -price;
+    }
+
+    size_t symbol_len = strlen(currency->symbol);
+    if (pos + symbol_len >= len) {
+        return 0;
+    }
+    memcpy(out + pos, currency->symbol, symbol_len);
+    pos += symbol_len;
+
+    size_t n = price_format_decimal(out + pos, len - pos, price, decimals, currency->group, currency->decimal);
+    return n ? pos + n : 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "price.h"
+
+// Price table dimensions
+#define PRICE_TABLE_MAX_ASSETS 4
+#define PRICE_TABLE_MAX_CURRENCIES 6
+
+// Currency display format
+typedef struct {
+    char code[4];         // CoinGecko vs_currency id, e.g. "usd"
+    const char *symbol;   // Prefix shown before the amount (glyph string, see font.h)
+    uint8_t decimals;     // Fraction digits shown for prices >= 1 (more below 1, see price.h)
+    char group;           // Thousands separator, 0 for none
+    char decimal;         // Decimal separator
+} currency_t;
+
+// Asset x currency price table, filled from one batched API response
+typedef struct {
+    price_t price[PRICE_TABLE_MAX_ASSETS][PRICE_TABLE_MAX_CURRENCIES];
+    bp_t change_24h[PRICE_TABLE_MAX_ASSETS][PRICE_TABLE_MAX_CURRENCIES];
+    uint32_t valid;       // Bit (asset * PRICE_TABLE_MAX_CURRENCIES + currency)
+} price_table_t;
+
+// Look up a supported currency by its code, NULL if unknown
+const currency_t *currency_find(const char *code);
+
+// Parse a comma separated list ("usd,eur,gbp") into currency pointers.
+// Unknown codes and duplicates are skipped. Returns the number of entries written.
+size_t currency_parse_list(const char *list, const currency_t **out, size_t max);
+
+// Price table accessors
+void price_table_set(price_table_t *table, int asset, int currency, price_t price, bp_t change_24h);
+bool price_table_get(const price_table_t *table, int asset, int currency, price_t *price, bp_t *change_24h);
+
+// Fill one asset row of the table from a CoinGecko simple/price response:
+// {"<asset_id>":{"usd":65000.12,"usd_24h_change":1.23,"eur":...}}
+// Numbers are parsed straight from the JSON digits, no heap or double.
+// The row is replaced, not merged: currencies missing from the response (omitted
+// or cut off by a truncated body) are marked invalid rather than keeping stale prices.
+// Returns true if at least one price was found.
+bool price_table_update_from_json(price_table_t *table, const char *json, const char *asset_id, int asset,
+                                  const currency_t *const *currencies, size_t count);
+
+// Format a price as "<symbol><grouped integer><decimal><fraction>" into a glyph string,
+// using integer math only. Returns the length, or 0 if out is too small.
+size_t currency_format_price(char *out, size_t len, price_t price, const currency_t *currency);
@@ -0,0 +1,138 @@
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include "dlog.h"
+
+#if DLOG_DEFERRED
+
+_Static_assert((DLOG_RING_LEN & (DLOG_RING_LEN - 1)) == 0, "DLOG_RING_LEN must be a power of two");
+_Static_assert(sizeof(void *) == sizeof(uint32_t), "dlog stores arguments as 32-bit words");
+
+#define DLOG_LINE_MAX 160
+
+typedef struct {
+    atomic_uint seq;              // Reservation index + 1 once the entry is complete
+    const char *tag;
+    const char *fmt;              // Format ID
+    uint32_t timestamp_ms;
+    uint8_t level;
+    uint8_t nargs;
+    uint32_t args[DLOG_MAX_ARGS];
+} dlog_entry_t;
+
+// Multi-producer, single-consumer ring. Producers reserve a slot by advancing head
+// with CAS and publish it through the slot's seq; the drain task advances tail.
+static dlog_entry_t ring[DLOG_RING_LEN];
+static atomic_uint ring_head;
+static atomic_uint ring_tail;
+static atomic_uint dropped;
+
+static StackType_t dlog_task_stack[DLOG_TASK_STACK_SIZE];
+static StaticTask_t dlog_task_tcb;
+
+void dlog_record(esp_log_level_t level, const char *tag, const char *fmt, int nargs, ...)
+{
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+
+    do {
+        if (head - atomic_load_explicit(&ring_tail, memory_order_acquire) >= DLOG_RING_LEN) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&ring_head, &head, head + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    dlog_entry_t *entry = &ring[head & (DLOG_RING_LEN - 1)];
+    va_list ap;
+
+    entry->tag = tag;
+    entry->fmt = fmt;
+    entry->timestamp_ms = esp_log_timestamp();
+    entry->level = level;
+    entry->nargs = nargs < DLOG_MAX_ARGS ? nargs : DLOG_MAX_ARGS;
+
+    va_start(ap, nargs);
+    for (int i = 0; i < entry->nargs; i++) {
+        entry->args[i] = va_arg(ap, uint32_t);
+    }
+    va_end(ap);
+
+    atomic_store_explicit(&entry->seq, head + 1, memory_order_release);
+}
+
+// Print one entry in the usual ESP_LOG layout, with the time it was recorded
+static void dlog_print(const dlog_entry_t *entry)
+{
+    static const char level_letters[] = "NEWIDV";
+    static char line[DLOG_LINE_MAX];
+    const uint32_t *a = entry->args;
+
+    // Unused trailing arguments are ignored by snprintf
+    snprintf(line, sizeof(line), entry->fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+    esp_log_write(entry->level, entry->tag, "%c (%u) %s: %s\n", level_letters[entry->level],
+                  (unsigned)entry->timestamp_ms, entry->tag, line);
+}
+
+// Drain task - formats and prints recorded entries at low priority
+static void dlog_task(void *pvParameter)
+{
+    unsigned reported_drops = 0;
+
+    while(1) {
+        unsigned tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+
+        while (1) {
+            const dlog_entry_t *slot = &ring[tail & (DLOG_RING_LEN - 1)];
+            if (atomic_load_explicit(&slot->seq, memory_order_acquire) != tail + 1) {
+                break;  // Empty, or the producer is still filling this slot
+            }
+
+            // Copy out before releasing the slot to producers
+            dlog_entry_t entry;
+            entry.tag = slot->tag;
+            entry.fmt = slot->fmt;
+            entry.timestamp_ms = slot->timestamp_ms;
+            entry.level = slot->level;
+            entry.nargs = slot->nargs;
+            for (int i = 0; i < DLOG_MAX_ARGS; i++) {
+                entry.args[i] = slot->args[i];
+            }
+            atomic_store_explicit(&ring_tail, ++tail, memory_order_release);
+
+            dlog_print(&entry);
+        }
+
+        unsigned drops = atomic_load_explicit(&dropped, memory_order_relaxed);
+        if (drops != reported_drops) {
+            ESP_LOGW("DLOG", "%u log entries dropped (%u total)", drops - reported_drops, drops);
+            reported_drops = drops;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(DLOG_DRAIN_INTERVAL_MS));
+    }
+}
+
+TaskHandle_t dlog_start(void)
+{
+    return xTaskCreateStatic(dlog_task, "dlog_task", DLOG_TASK_STACK_SIZE, NULL, 1,
+                             dlog_task_stack, &dlog_task_tcb);
+}
+
+uint32_t dlog_dropped(void)
+{
+    return atomic_load_explicit(&dropped, memory_order_relaxed);
+}
+
+#else
+
+TaskHandle_t dlog_start(void)
+{
+    return NULL;
+}
+
+uint32_t dlog_dropped(void)
+{
+    return 0;
+}
+
+#endif // DLOG_DEFERRED
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Deferred binary logging for hot paths (fetch, redraw, WiFi/HTTP handlers).
+// DLOGx() stores the format string address (the format ID), a timestamp and the
+// raw arguments in a lock-free ring; a low-priority task formats and prints them.
+// Entries are dropped (and counted) when the ring is full, never blocking the caller.
+//
+// Arguments must be 32-bit (int, unsigned, char, pointers) and %s arguments must
+// point to storage that outlives the entry (literals, static tables), since
+// formatting happens later. At most DLOG_MAX_ARGS arguments.
+//
+// Set DLOG_DEFERRED to 0 to compile every DLOGx() back to a synchronous ESP_LOGx().
+#ifndef DLOG_DEFERRED
+#define DLOG_DEFERRED 1
+#endif
+
+#define DLOG_RING_LEN 64          // Entries, power of two
+#define DLOG_MAX_ARGS 6
+#define DLOG_TASK_STACK_SIZE 3072
+#define DLOG_DRAIN_INTERVAL_MS 50
+
+#if DLOG_DEFERRED
+
+// Argument count, 0 to DLOG_MAX_ARGS
+#define DLOG_NARGS(...) DLOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+
+#define DLOGE(tag, fmt, ...) dlog_record(ESP_LOG_ERROR, tag, fmt, DLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define DLOGW(tag, fmt, ...) dlog_record(ESP_LOG_WARN, tag, fmt, DLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define DLOGI(tag, fmt, ...) dlog_record(ESP_LOG_INFO, tag, fmt, DLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+// Record one entry. Safe from any task or ISR; never blocks.
+void dlog_record(esp_log_level_t level, const char *tag, const char *fmt, int nargs, ...)
+    __attribute__((format(printf, 3, 5)));
+
+#else
+
+#define DLOGE(tag, fmt, ...) ESP_LOGE(tag, fmt, ##__VA_ARGS__)
+#define DLOGW(tag, fmt, ...) ESP_LOGW(tag, fmt, ##__VA_ARGS__)
+#define DLOGI(tag, fmt, ...) ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+
+#endif // DLOG_DEFERRED
+
+// Start the drain task (static storage). Returns its handle, NULL when DLOG_DEFERRED is 0.
+// Entries recorded before this are kept and printed once it runs.
+TaskHandle_t dlog_start(void);
+
+// Entries lost to a full ring since boot
+uint32_t dlog_dropped(void);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+// 5x7 bitmap font
+// Glyph indices equal ASCII codes for 0x20-0x5F, so a glyph string is also a
+// plain C string. Lowercase letters render with the uppercase glyphs and
+// currency symbols outside ASCII use the indices below.
+#define FONT_WIDTH 5
+#define FONT_HEIGHT 7
+#define FONT_ADVANCE 6   // Glyph width plus one column of spacing
+
+#define GLYPH_EURO  0x80
+#define GLYPH_POUND 0x81
+#define GLYPH_YEN   0x82
+
+// Column data for a glyph (FONT_WIDTH bytes, bit 0 = top row).
+// Unknown glyphs render as a space.
+const uint8_t *font_glyph(uint8_t glyph);
@@ -0,0 +1,145 @@
+#include <string.h>
+#include "framebuffer.h"
+#include "font.h"
+
+void fb_clear(framebuffer_t *fb)
+{
+    memset(fb->pixels, 0, sizeof(fb->pixels));
+}
+
+void fb_invalidate(framebuffer_t *fb)
+{
+    fb->shadow_valid = false;
+}
+
+static inline void fb_set_pixel(framebuffer_t *fb, int x, int y, bool on)
+{
+    if ((unsigned)x >= FB_WIDTH || (unsigned)y >= FB_HEIGHT) {
+        return;
+    }
+    if (on) {
+        fb->pixels[y >> 3][x] |= (uint8_t)(1u << (y & 7));
+    } else {
+        fb->pixels[y >> 3][x] &= (uint8_t)~(1u << (y & 7));
+    }
+}
+
+void fb_fill_rect(framebuffer_t *fb, int x, int y, int w, int h, bool on)
+{
+    for (int yy = y; yy < y + h; yy++) {
+        for (int xx = x; xx < x + w; xx++) {
+            fb_set_pixel(fb, xx, yy, on);
+        }
+    }
+}
+
+void fb_draw_bitmap(framebuffer_t *fb, int x, int y, const uint8_t *bitmap, int w, int h)
+{
+    const int stride = (w + 7) / 8;
+
+    for (int row = 0; row < h; row++) {
+        for (int col = 0; col < w; col++) {
+            if (bitmap[row * stride + col / 8] & (0x80 >> (col & 7))) {
+                fb_set_pixel(fb, x + col, y + row, true);
+            }
+        }
+    }
+}
+
+// OR (or clear) one glyph column into the page(s) it spans
+static inline void fb_blit_column(framebuffer_t *fb, int x, int y, uint8_t bits, bool on)
+{
+    const int page = y >> 3;
+    const int shift = y & 7;
+    const uint16_t mask = (uint16_t)bits << shift;
+
+    if ((unsigned)x >= FB_WIDTH) {
+        return;
+    }
+    if ((unsigned)page < FB_PAGES) {
+        if (on) fb->pixels[page][x] |= (uint8_t)mask;
+        else    fb->pixels[page][x] &= (uint8_t)~mask;
+    }
+    if (shift && (unsigned)(page + 1) < FB_PAGES) {
+        if (on) fb->pixels[page + 1][x] |= (uint8_t)(mask >> 8);
+        else    fb->pixels[page + 1][x] &= (uint8_t)~(mask >> 8);
+    }
+}
+
+int fb_glyphs_width(size_t count, int scale)
+{
+    return count ? (int)count * FONT_ADVANCE * scale - scale : 0;
+}
+
+int fb_draw_glyphs(framebuffer_t *fb, int x, int y, const uint8_t *glyphs, size_t count, int scale, bool on)
+{
+    int cx = x;
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *columns = font_glyph(glyphs[i]);
+
+        for (int col = 0; col < FONT_WIDTH; col++) {
+            uint8_t bits = columns[col];
+
+            if (scale == 1) {
+                // Fast path: whole column in one or two page writes
+                fb_blit_column(fb, cx + col, y, bits, on);
+                continue;
+            }
+            for (int row = 0; row < FONT_HEIGHT; row++) {
+                if (bits & (1u << row)) {
+                    for (int dy = 0; dy < scale; dy++) {
+                        for (int dx = 0; dx < scale; dx++) {
+                            fb_set_pixel(fb, cx + col * scale + dx, y + row * scale + dy, on);
+                        }
+                    }
+                }
+            }
+        }
+        cx += FONT_ADVANCE * scale;
+    }
+
+    return fb_glyphs_width(count, scale);
+}
+
+int fb_flush(framebuffer_t *fb, fb_write_fn write, void *ctx)
+{
+    uint8_t buf[1 + FB_WIDTH];
+    int total = 0;
+
+    for (int page = 0; page < FB_PAGES; page++) {
+        const uint8_t *row = fb->pixels[page];
+        const uint8_t *old = fb->shadow[page];
+        int x0 = 0;
+        int x1 = FB_WIDTH - 1;
+
+        if (fb->shadow_valid) {
+            while (x0 < FB_WIDTH && row[x0] == old[x0]) {
+                x0++;
+            }
+            if (x0 == FB_WIDTH) {
+                continue;  // Page unchanged
+            }
+            while (row[x1] == old[x1]) {
+                x1--;
+            }
+        }
+
+        // Column and page address window, then the dirty span as one data transaction
+        const uint8_t cmd[] = { FB_CTRL_COMMAND, 0x21, (uint8_t)x0, (uint8_t)x1, 0x22, (uint8_t)page, (uint8_t)page };
+        const size_t len = (size_t)(x1 - x0 + 1);
+
+        buf[0] = FB_CTRL_DATA;
+        memcpy(buf + 1, row + x0, len);
+
+        if (write(ctx, cmd, sizeof(cmd)) != 0 || write(ctx, buf, len + 1) != 0) {
+            fb->shadow_valid = false;
+            return -1;
+        }
+        memcpy(fb->shadow[page] + x0, row + x0, len);
+        total += (int)(sizeof(cmd) + len + 1);
+    }
+
+    fb->shadow_valid = true;
+    return total;
+}
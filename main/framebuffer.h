@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// SSD1306 framebuffer in panel layout: 8 pages of 128 columns, bit 0 = top row of the page
+#define FB_WIDTH 128
+#define FB_HEIGHT 64
+#define FB_PAGES (FB_HEIGHT / 8)
+
+// SSD1306 control bytes
+#define FB_CTRL_COMMAND 0x00
+#define FB_CTRL_DATA    0x40
+
+typedef struct {
+    uint8_t pixels[FB_PAGES][FB_WIDTH];
+    uint8_t shadow[FB_PAGES][FB_WIDTH];  // Content last sent to the panel
+    bool shadow_valid;
+} framebuffer_t;
+
+// Send one I2C transaction (first byte is the control byte). Returns 0 on success.
+typedef int (*fb_write_fn)(void *ctx, const uint8_t *bytes, size_t len);
+
+void fb_clear(framebuffer_t *fb);
+void fb_invalidate(framebuffer_t *fb);  // Force a full redraw on the next flush
+void fb_fill_rect(framebuffer_t *fb, int x, int y, int w, int h, bool on);
+
+// Row-major, MSB-first bitmap (Adafruit drawBitmap layout)
+void fb_draw_bitmap(framebuffer_t *fb, int x, int y, const uint8_t *bitmap, int w, int h);
+
+// Draw a glyph string (see font.h) at integer scale. Returns the drawn width in pixels.
+int fb_draw_glyphs(framebuffer_t *fb, int x, int y, const uint8_t *glyphs, size_t count, int scale, bool on);
+int fb_glyphs_width(size_t count, int scale);
+
+// Send only the changed column span of each page. Returns the number of bytes written,
+// or -1 if a write failed (the shadow is then invalidated so the next flush resends).
+int fb_flush(framebuffer_t *fb, fb_write_fn write, void *ctx);
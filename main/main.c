@@ -1,9 +1,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <math.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "freertos/event_groups.h"
 #include "esp_system.h"
 #include "esp_wifi.h"
@@ -14,7 +14,16 @@
 #include "driver/gpio.h"
 #include "driver/i2c.h"
 #include "nvs_flash.h"
-#include "cJSON.h"
+#include "price.h"
+#include "alerts.h"
+#include "currency.h"
+#include "framebuffer.h"
+#include "ui.h"
+#include "metrics.h"
+#include "i2c_scanner.h"
+#include "settings.h"
+#include "console.h"
+#include "dlog.h"
 
 // Test Configuration - Set to 1 for breadboard testing
 #define BREADBOARD_TEST_MODE 1
@@ -28,6 +37,15 @@
 #define I2C_MASTER_NUM I2C_NUM_0
 #define I2C_MASTER_FREQ_HZ 100000
 
+// Scan the bus and benchmark SSD1306 writes at each clock at boot, then run at the
+// fastest error-free speed (0 to stay at I2C_MASTER_FREQ_HZ)
+#define I2C_DIAG_AT_BOOT 1
+
+// The SSD1306 is rated for 400 kHz. Set to 1 to also try 800 kHz and 1 MHz; the diagnostic
+// only sees NACKs/timeouts, not whether display RAM received the data, so check the
+// screen for corruption before relying on it.
+#define I2C_DIAG_OVERCLOCK 0
+
 // Pin Configuration
 #define BUTTON_PIN GPIO_NUM_4  // Button pin (matches schematic - connected to 3.3V)
 #define LED_PIN GPIO_NUM_7     // LED pin (matches schematic - through 2KΩ + 2KΩ resistors)
@@ -38,40 +56,92 @@
 // - LED: GPIO 7 → 2KΩ resistor → LED anode → 2KΩ resistor → GND (Pin 24)
 // - Total LED resistance: 4KΩ (will be dimmer than expected)
 
-// WiFi Configuration - Now configurable via NVS
-#define WIFI_SSID_DEFAULT "Your_WiFi_SSID"  // Default fallback
-#define WIFI_PASS_DEFAULT "Your_WiFi_Password"  // Default fallback
+// WiFi Configuration - credentials live in the settings store (see settings.h)
 #define WIFI_MAX_RETRY_COUNT 5
 #define WIFI_RETRY_DELAY_MS 1000
 
-// NVS Keys for WiFi credentials
-#define NVS_NAMESPACE "wifi_config"
-#define NVS_KEY_SSID "ssid"
-#define NVS_KEY_PASS "password"
-
-// API Configuration
-#define API_URL "https://api.coingecko.com/api/v3/simple/price?ids=bitcoin&vs_currencies=usd&include_24hr_change=true"
-
-// Bitcoin Icon (24x24px)
-static const unsigned char bitcoin_icon[] = {
-    0x00, 0x7e, 0x00, 0x03, 0xff, 0xc0, 0x07, 0x81, 0xe0, 0x0e, 0x00, 0x70, 0x18, 0x28, 0x18, 0x30,
-    0x28, 0x0c, 0x70, 0xfc, 0x0e, 0x60, 0xfe, 0x06, 0x60, 0xc7, 0x06, 0xc0, 0xc3, 0x03, 0xc0, 0xc7,
-    0x03, 0xc0, 0xfe, 0x03, 0xc0, 0xff, 0x03, 0xc0, 0xc3, 0x83, 0xc0, 0xc1, 0x83, 0xc0, 0x60, 0xc3, 0x86,
-    0x60, 0xff, 0x06, 0x70, 0xfe, 0x0e, 0x30, 0x28, 0x0c, 0x18, 0x28, 0x18, 0x0e, 0x00, 0x70, 0x07,
-    0x81, 0xe0, 0x03, 0xff, 0xc0, 0x00, 0x7e, 0x00
-};
+// Alert signaling
+#define LED_PATTERN_STEP_MS 100
+#define LED_PATTERN_REPEATS 8   // 8 x 1.6s of blinking per alert
+
+// API Configuration - ids and vs_currencies are filled from the settings
+#define API_URL_BASE "https://api.coingecko.com/api/v3/simple/price?ids="
+#define API_URL_CURRENCIES "&vs_currencies="
+#define API_URL_SUFFIX "&include_24hr_change=true"
+#define API_ASSET_INDEX 0
+
+// Button gestures
+#define LONG_PRESS_US 800000  // Hold >= 800ms to switch currency
+
+// Task stacks (bytes) - all long-lived tasks and queues are statically allocated.
+// Check the stack_free figures in the METRICS log line before changing these.
+#define BUTTON_TASK_STACK_SIZE 2048
+#define MAIN_TASK_STACK_SIZE 6144   // TLS handshake runs on this stack
+#define LED_TASK_STACK_SIZE 2048
+#define UI_EVENT_QUEUE_LEN 4
+
+// HTTP client buffers, allocated once at init
+#define HTTP_RX_BUFFER_SIZE 1024
+#define HTTP_TX_BUFFER_SIZE 512
+
+// UI events from the button task, handled by the main task
+typedef enum {
+    UI_EVENT_TOGGLE,
+    UI_EVENT_NEXT_CURRENCY,
+    UI_EVENT_FEED_CHANGED,      // Console edited the asset or currency set
+    UI_EVENT_RULES_CHANGED,     // Console edited the alert rules
+} ui_event_t;
 
 // Global Variables
 static const char *TAG = "BITCOIN_FETCHER";
 static bool display_active = false;
 static bool fetch_in_progress = false;
 static char last_price[32] = "";
+static char api_url[224] = "";
 static int64_t last_fetch_time = 0;
-static const int64_t fetch_cooldown = 600000000; // 10 minutes in microseconds
+static int64_t last_metrics_time = 0;
 static int64_t last_button_press = 0;
+static int64_t button_press_start = 0;
 static const int64_t debounce_delay = 200000; // 200ms in microseconds
 
+// Alert engine state
+static alert_rule_t alert_rules[ALERT_MAX_RULES];
+static size_t alert_rule_count = 0;
+static alert_engine_t alert_engine;
+static char alert_asset_id[32] = "";           // Feed the engine history was built from
+static const currency_t *alert_currency = NULL;
+static char alert_banner[32] = "";
+static volatile uint8_t led_alert_pattern = ALERT_LED_NONE;
+static volatile uint8_t led_alert_repeats = 0;
+
+// Currency state: configured set, cached prices and the currency on screen
+static const currency_t *currencies[PRICE_TABLE_MAX_CURRENCIES];
+static size_t currency_count = 0;
+static price_table_t price_table;
+static char feed_asset_id[32] = "";           // Asset api_url was built for (copied from the settings)
+static char feed_asset_symbol[8] = "";
+static volatile uint8_t display_currency = 0;
+
+// Display buffer
+static framebuffer_t framebuffer;
+
+// HTTP response buffer
+static char http_response[768];
+static size_t http_response_len = 0;
+
+// Static task and queue storage
+static StackType_t button_task_stack[BUTTON_TASK_STACK_SIZE];
+static StackType_t main_task_stack[MAIN_TASK_STACK_SIZE];
+static StackType_t led_task_stack[LED_TASK_STACK_SIZE];
+static StaticTask_t button_task_tcb;
+static StaticTask_t main_task_tcb;
+static StaticTask_t led_task_tcb;
+static uint8_t ui_event_queue_storage[UI_EVENT_QUEUE_LEN * sizeof(ui_event_t)];
+static StaticQueue_t ui_event_queue_struct;
+static QueueHandle_t ui_event_queue;
+
 // Event group for WiFi
+static StaticEventGroup_t wifi_event_group_struct;
 static EventGroupHandle_t wifi_event_group;
 const int WIFI_CONNECTED_BIT = BIT0;
 
@@ -81,25 +151,33 @@ static esp_http_client_handle_t http_client;
 // Function declarations
 static void wifi_init_sta(void);
 static void i2c_master_init(void);
+static void i2c_bus_diagnose(void);
 static void gpio_init(void);
 static void display_init(void);
 static void show_welcome_screen(void);
-static void display_bitcoin_data(const char *price, double change_24h);
+static void display_bitcoin_data(price_t price, bp_t change_24h, const currency_t *currency);
 static void display_error(const char *error_msg);
 static void display_message(const char *title, const char *message);
 static void display_standby(void);
 static void fetch_bitcoin_data(void);
-static void print_center(const char *buf, int x, int y);
 static void ssd1306_command(uint8_t cmd);
-static void ssd1306_data(uint8_t data);
-static void ssd1306_clear(void);
+static int ssd1306_write(void *ctx, const uint8_t *bytes, size_t len);
 static void ssd1306_display(void);
-static void ssd1306_draw_bitmap(int x, int y, const unsigned char *bitmap, int w, int h);
 
-// WiFi configuration functions
-static esp_err_t wifi_config_load_from_nvs(char *ssid, char *password);
-static esp_err_t wifi_config_save_to_nvs(const char *ssid, const char *password);
-static void wifi_config_set_defaults(char *ssid, char *password);
+// Alert functions
+static void alerts_init(void);
+static void alerts_process_sample(price_t price);
+static void alert_format_banner(const alert_event_t *event, char *buf, size_t len);
+
+// Currency functions
+static void currencies_init(void);
+static void currency_switch_next(void);
+static void display_current_price(void);
+
+// Settings functions
+static void settings_apply_feed(void);
+static void settings_apply_rules(void);
+static void console_settings_changed(console_change_t change);
 
 // WiFi event handler
 static void event_handler(void* arg, esp_event_base_t event_base,
@@ -108,12 +186,12 @@ static void event_handler(void* arg, esp_event_base_t event_base,
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
         esp_wifi_connect();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        ESP_LOGI(TAG, "WiFi disconnected, trying to reconnect...");
+        DLOGI(TAG, "WiFi disconnected, trying to reconnect...");
         esp_wifi_connect();
         xEventGroupClearBits(wifi_event_group, WIFI_CONNECTED_BIT);
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
-        ESP_LOGI(TAG, "Got IP:" IPSTR, IP2STR(&event->ip_info.ip));
+        DLOGI(TAG, "Got IP:" IPSTR, IP2STR(&event->ip_info.ip));
         xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_BIT);
     }
 }
@@ -123,10 +201,17 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 {
     switch(evt->event_id) {
         case HTTP_EVENT_ON_DATA:
-            // Handle response data
+            // Accumulate response body (API response is small and fits the buffer)
+            if (http_response_len + evt->data_len < sizeof(http_response)) {
+                memcpy(http_response + http_response_len, evt->data, evt->data_len);
+                http_response_len += evt->data_len;
+                http_response[http_response_len] = '\0';
+            } else {
+                DLOGW(TAG, "HTTP response truncated");
+            }
             break;
         case HTTP_EVENT_ERROR:
-            ESP_LOGE(TAG, "HTTP Client Error");
+            DLOGE(TAG, "HTTP Client Error");
             break;
         default:
             break;
@@ -135,45 +220,114 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 }
 
 // Button task
+// Short press toggles active/standby, long press switches the displayed currency.
+// Actions are queued to the main task so the button stays responsive during fetches.
 static void button_task(void *pvParameter)
 {
     bool last_button_state = false;
     
     while(1) {
         bool button_state = gpio_get_level(BUTTON_PIN);
+        int64_t now = esp_timer_get_time();
         
-        if (button_state != last_button_state && button_state && 
-            (esp_timer_get_time() - last_button_press > debounce_delay)) {
-            
-            last_button_press = esp_timer_get_time();
-            display_active = !display_active;
+        if (button_state != last_button_state && (now - last_button_press > debounce_delay)) {
+            last_button_press = now;
             
-            if (display_active) {
-                ESP_LOGI(TAG, "Program started");
-                gpio_set_level(LED_PIN, 1);
-                fetch_bitcoin_data();
-                last_fetch_time = esp_timer_get_time();
+            if (button_state) {
+                button_press_start = now;
             } else {
-                ESP_LOGI(TAG, "Program stopped");
-                gpio_set_level(LED_PIN, 0);
-                display_standby();
+                ui_event_t event = (display_active && now - button_press_start >= LONG_PRESS_US)
+                                   ? UI_EVENT_NEXT_CURRENCY : UI_EVENT_TOGGLE;
+                if (xQueueSend(ui_event_queue, &event, 0) != pdTRUE) {
+                    DLOGW(TAG, "UI event queue full, button press dropped");
+                }
             }
+            
+            last_button_state = button_state;
         }
         
-        last_button_state = button_state;
         vTaskDelay(pdMS_TO_TICKS(10));
     }
 }
 
-// Main task
+// LED task - plays alert blink patterns, then restores the active/standby state
+static void led_task(void *pvParameter)
+{
+    uint8_t step = 0;
+
+    while(1) {
+        uint8_t pattern = led_alert_pattern;
+
+        if (pattern != ALERT_LED_NONE) {
+            gpio_set_level(LED_PIN, (alert_led_pattern_bits(pattern) >> step) & 1);
+            if (++step == 16) {
+                step = 0;
+                if (led_alert_repeats == 0 || --led_alert_repeats == 0) {
+                    led_alert_pattern = ALERT_LED_NONE;
+                    gpio_set_level(LED_PIN, display_active ? 1 : 0);
+                }
+            }
+        } else {
+            step = 0;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(LED_PATTERN_STEP_MS));
+    }
+}
+
+// Handle a queued button action
+static void handle_ui_event(ui_event_t event)
+{
+    if (event == UI_EVENT_NEXT_CURRENCY) {
+        currency_switch_next();
+        return;
+    }
+    if (event == UI_EVENT_FEED_CHANGED) {
+        settings_apply_feed();
+        return;
+    }
+    if (event == UI_EVENT_RULES_CHANGED) {
+        settings_apply_rules();
+        return;
+    }
+    
+    display_active = !display_active;
+    
+    if (display_active) {
+        DLOGI(TAG, "Program started");
+        gpio_set_level(LED_PIN, 1);
+        fetch_bitcoin_data();
+        last_fetch_time = esp_timer_get_time();
+    } else {
+        DLOGI(TAG, "Program stopped");
+        gpio_set_level(LED_PIN, 0);
+        display_standby();
+    }
+}
+
+// Main task - owns the display and the HTTP client
 static void main_task(void *pvParameter)
 {
+    ui_event_t event;
+    
     while(1) {
-        if (display_active && (esp_timer_get_time() - last_fetch_time >= fetch_cooldown) && !fetch_in_progress) {
+        if (xQueueReceive(ui_event_queue, &event, pdMS_TO_TICKS(1000)) == pdTRUE) {
+            handle_ui_event(event);
+        }
+        
+        const settings_t *settings = settings_get();
+        int64_t now = esp_timer_get_time();
+        if (display_active && (now - last_fetch_time >= settings->fetch_interval_s * 1000000LL) && !fetch_in_progress) {
             fetch_bitcoin_data();
             last_fetch_time = esp_timer_get_time();
         }
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        if (now - last_metrics_time >= settings->metrics_interval_s * 1000000LL) {
+            metrics_report();
+            last_metrics_time = now;
+        }
+        
+        // Coalesced settings writes (currency switches, console edits)
+        settings_poll(now);
     }
 }
 
@@ -181,6 +335,9 @@ void app_main(void)
 {
     ESP_LOGI(TAG, "Starting Bitcoin Price Fetcher...");
     
+    // Hot-path log entries are formatted by this low-priority task (see dlog.h)
+    TaskHandle_t dlog_handle = dlog_start();
+    
     #if BREADBOARD_TEST_MODE
     ESP_LOGI(TAG, "BREADBOARD TEST MODE ENABLED - Check connections!");
     #endif
@@ -193,15 +350,38 @@ void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
     
+    // Load all settings in one read (migrates legacy NVS keys on first boot)
+    if (settings_init() != ESP_OK) {
+        ESP_LOGW(TAG, "Running with default settings");
+    }
+    
+    // Console first, so WiFi credentials can be fixed even when WiFi never connects.
+    // Its edits are queued to the main task, which picks them up once it runs.
+    ui_event_queue = xQueueCreateStatic(UI_EVENT_QUEUE_LEN, sizeof(ui_event_t),
+                                        ui_event_queue_storage, &ui_event_queue_struct);
+    TaskHandle_t console_handle = console_start(console_settings_changed);
+    
     // Initialize GPIO
     gpio_init();
     
     // Initialize I2C
     i2c_master_init();
     
+    #if I2C_DIAG_AT_BOOT
+    // Pick the bus speed before the display is initialized (and cleared)
+    i2c_bus_diagnose();
+    #endif
+    
     // Initialize display
     display_init();
     
+    // Load currency set, build the API URL and compile alert rules. The console
+    // is already running, so read the settings under the lock.
+    settings_lock();
+    currencies_init();
+    alerts_init();
+    settings_unlock(false);
+    
     // Show welcome screen
     show_welcome_screen();
     
@@ -211,25 +391,36 @@ void app_main(void)
     vTaskDelay(pdMS_TO_TICKS(3000));
     #endif
     
-    // Initialize WiFi
+    // Initialize WiFi. Startup does not wait for the connection: fetches made while
+    // offline show "WiFi Disconnected" and the event handler keeps reconnecting.
     wifi_init_sta();
     
-    // Wait for WiFi connection
-    xEventGroupWaitBits(wifi_event_group, WIFI_CONNECTED_BIT, false, true, portMAX_DELAY);
-    
-    // Initialize HTTP client
+    // Initialize HTTP client (buffers are allocated once here and reused for every fetch)
     esp_http_client_config_t config = {
-        .url = API_URL,
+        .url = api_url,
         .event_handler = http_event_handler,
         .timeout_ms = 10000,
+        .buffer_size = HTTP_RX_BUFFER_SIZE,
+        .buffer_size_tx = HTTP_TX_BUFFER_SIZE,
     };
     http_client = esp_http_client_init(&config);
     
-    // Create tasks
-    xTaskCreate(button_task, "button_task", 2048, NULL, 10, NULL);
-    xTaskCreate(main_task, "main_task", 4096, NULL, 5, NULL);
-    
-    ESP_LOGI(TAG, "System ready! Press button to start program.");
+    // Create tasks from static storage
+    TaskHandle_t button_handle = xTaskCreateStatic(button_task, "button_task", BUTTON_TASK_STACK_SIZE, NULL, 10,
+                                                   button_task_stack, &button_task_tcb);
+    TaskHandle_t main_handle = xTaskCreateStatic(main_task, "main_task", MAIN_TASK_STACK_SIZE, NULL, 5,
+                                                 main_task_stack, &main_task_tcb);
+    TaskHandle_t led_handle = xTaskCreateStatic(led_task, "led_task", LED_TASK_STACK_SIZE, NULL, 4,
+                                                led_task_stack, &led_task_tcb);
+    metrics_register_task(button_handle, "button", BUTTON_TASK_STACK_SIZE);
+    metrics_register_task(main_handle, "main", MAIN_TASK_STACK_SIZE);
+    metrics_register_task(led_handle, "led", LED_TASK_STACK_SIZE);
+    metrics_register_task(console_handle, "console", CONSOLE_TASK_STACK_SIZE);
+    metrics_register_task(dlog_handle, "dlog", DLOG_TASK_STACK_SIZE);
+    
+    metrics_report();
+    
+    ESP_LOGI(TAG, "System ready! Press button to start program. Type 'help' for the settings console.");
 }
 
 // GPIO initialization
@@ -266,6 +457,36 @@ static void i2c_master_init(void)
     i2c_driver_install(I2C_MASTER_NUM, conf.mode, 0, 0, 0);
 }
 
+// Boot-time bus diagnostic; the report is exported with every metrics line
+static void i2c_bus_diagnose(void)
+{
+    static const uint32_t speeds[] = {
+        I2C_MASTER_FREQ_HZ, 400000,
+        #if I2C_DIAG_OVERCLOCK
+        800000, 1000000,
+        #endif
+    };
+    static i2c_diag_report_t report;
+    static char report_json[640];
+    const i2c_diag_config_t config = {
+        .port = I2C_MASTER_NUM,
+        .sda_io_num = I2C_MASTER_SDA_IO,
+        .scl_io_num = I2C_MASTER_SCL_IO,
+        .device_addr = SCREEN_ADDRESS,
+        .speeds_hz = speeds,
+        .speed_count = sizeof(speeds) / sizeof(speeds[0]),
+    };
+
+    esp_err_t err = i2c_diag_run(&config, &report);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "I2C diagnostic failed (%s), staying at %d Hz", esp_err_to_name(err), I2C_MASTER_FREQ_HZ);
+    }
+    i2c_diag_log(&report);
+
+    i2c_diag_format_json(&report, report_json, sizeof(report_json));
+    metrics_add_section("i2c", report_json);
+}
+
 // Display initialization
 static void display_init(void)
 {
@@ -295,98 +516,79 @@ static void display_init(void)
     ssd1306_command(0xA4); // Display all on resume
     ssd1306_command(0xA6); // Normal display
     ssd1306_command(0xAF); // Display on
+    
+    // Panel RAM is undefined after reset: push a full blank frame
+    fb_invalidate(&framebuffer);
+    fb_clear(&framebuffer);
+    ssd1306_display();
 }
 
 // SSD1306 command
 static void ssd1306_command(uint8_t cmd)
 {
-    i2c_cmd_handle_t cmd_handle = i2c_cmd_link_create();
-    i2c_master_start(cmd_handle);
-    i2c_master_write_byte(cmd_handle, (SCREEN_ADDRESS << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd_handle, 0x00, true); // Command mode
-    i2c_master_write_byte(cmd_handle, cmd, true);
-    i2c_master_stop(cmd_handle);
-    i2c_master_cmd_begin(I2C_MASTER_NUM, cmd_handle, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd_handle);
+    const uint8_t bytes[] = { FB_CTRL_COMMAND, cmd };
+    ssd1306_write(NULL, bytes, sizeof(bytes));
 }
 
-// SSD1306 data
-static void ssd1306_data(uint8_t data)
+// SSD1306 write - one I2C transaction, first byte is the control byte.
+// Uses the driver's stack-allocated command link, no heap per transfer.
+static int ssd1306_write(void *ctx, const uint8_t *bytes, size_t len)
 {
-    i2c_cmd_handle_t cmd_handle = i2c_cmd_link_create();
-    i2c_master_start(cmd_handle);
-    i2c_master_write_byte(cmd_handle, (SCREEN_ADDRESS << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd_handle, 0x40, true); // Data mode
-    i2c_master_write_byte(cmd_handle, data, true);
-    i2c_master_stop(cmd_handle);
-    i2c_master_cmd_begin(I2C_MASTER_NUM, cmd_handle, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd_handle);
-}
-
-// Clear display
-static void ssd1306_clear(void)
-{
-    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT / 8; i++) {
-        ssd1306_data(0x00);
-    }
+    esp_err_t err = i2c_master_write_to_device(I2C_MASTER_NUM, SCREEN_ADDRESS, bytes, len, pdMS_TO_TICKS(100));
+    return err == ESP_OK ? 0 : -1;
 }
 
-// Display buffer
+// Send the changed parts of the display buffer to the panel
 static void ssd1306_display(void)
 {
-    // This is a simplified version - in a real implementation you'd use a buffer
-    // For now, we'll just clear and redraw
-}
-
-// Draw bitmap
-static void ssd1306_draw_bitmap(int x, int y, const unsigned char *bitmap, int w, int h)
-{
-    // Simplified bitmap drawing - in a real implementation you'd need proper buffer management
-    // This is a placeholder for the actual implementation
+    if (fb_flush(&framebuffer, ssd1306_write, NULL) < 0) {
+        DLOGW(TAG, "Display update failed");
+    }
 }
 
 // Show welcome screen
 static void show_welcome_screen(void)
 {
-    ssd1306_clear();
-    // In a real implementation, you'd draw text and graphics here
-    ESP_LOGI(TAG, "Welcome Screen Displayed");
+    ui_draw_welcome(&framebuffer, feed_asset_id);
+    ssd1306_display();
+    DLOGI(TAG, "Welcome Screen Displayed");
 }
 
 // Display bitcoin data
-static void display_bitcoin_data(const char *price, double change_24h)
+// Price and change are formatted straight into glyph strings, no printf or floating point
+static void display_bitcoin_data(price_t price, bp_t change_24h, const currency_t *currency)
 {
-    ssd1306_clear();
-    // Draw bitcoin icon and price data
-    ESP_LOGI(TAG, "Bitcoin Price: $%s, 24h Change: %.1f%%", price, change_24h);
+    ui_draw_price(&framebuffer, feed_asset_id, price, change_24h, currency, alert_banner,
+                  last_price, sizeof(last_price));
+    ssd1306_display();
+    
+    DLOGI(TAG, "Bitcoin Price: %d.%08d %s, 24h Change: %d bp",
+          (int)(price / PRICE_SCALE), (int)(price % PRICE_SCALE), currency->code, (int)change_24h);
 }
 
 // Display error
 static void display_error(const char *error_msg)
 {
-    ssd1306_clear();
-    ESP_LOGE(TAG, "Display Error: %s", error_msg);
+    ui_draw_message(&framebuffer, "ERROR", error_msg);
+    ssd1306_display();
+    DLOGE(TAG, "Display Error: %s", error_msg);
     gpio_set_level(LED_PIN, 0);
 }
 
 // Display message
 static void display_message(const char *title, const char *message)
 {
-    ssd1306_clear();
-    ESP_LOGI(TAG, "Display Message - Title: %s, Message: %s", title, message);
+    ui_draw_message(&framebuffer, title, message);
+    ssd1306_display();
+    DLOGI(TAG, "Display Message - Title: %s, Message: %s", title, message);
 }
 
 // Display standby
 static void display_standby(void)
 {
-    ssd1306_clear();
-    ESP_LOGI(TAG, "Display Standby");
-}
-
-// Print center (placeholder)
-static void print_center(const char *buf, int x, int y)
-{
-    // This would handle text positioning in a real implementation
+    ui_draw_standby(&framebuffer);
+    ssd1306_display();
+    DLOGI(TAG, "Display Standby");
 }
 
 // Fetch bitcoin data
@@ -395,33 +597,53 @@ static void fetch_bitcoin_data(void)
     if (xEventGroupGetBits(wifi_event_group) & WIFI_CONNECTED_BIT) {
         fetch_in_progress = true;
         
-        ESP_LOGI(TAG, "Fetching Bitcoin data from CoinGecko...");
+        DLOGI(TAG, "Fetching Bitcoin data from CoinGecko...");
         
         // Set URL
-        esp_http_client_set_url(http_client, API_URL);
+        esp_http_client_set_url(http_client, api_url);
         
         // Add headers
         esp_http_client_set_header(http_client, "User-Agent", "ESP32-Bitcoin-Fetcher/1.0");
         
-        // Perform request
+        // Reset response buffer
+        http_response_len = 0;
+        http_response[0] = '\0';
+        
+        // Perform request (heap sampled around it, see metrics.h)
+        metrics_fetch_begin();
         esp_err_t err = esp_http_client_perform(http_client);
+        metrics_fetch_end();
         
         if (err == ESP_OK) {
             int status_code = esp_http_client_get_status_code(http_client);
             int content_length = esp_http_client_get_content_length(http_client);
             
-            ESP_LOGI(TAG, "HTTP Status = %d, content_length = %d", status_code, content_length);
+            DLOGI(TAG, "HTTP Status = %d, content_length = %d", status_code, content_length);
             
             if (status_code == 200) {
-                // Parse response
-                // In a real implementation, you'd parse the JSON response here
-                ESP_LOGI(TAG, "Bitcoin data fetched successfully");
+                // Parse response into the price table, then render from it
+                if (price_table_update_from_json(&price_table, http_response, feed_asset_id, API_ASSET_INDEX,
+                                                 currencies, currency_count)) {
+                    price_t price;
+                    bp_t change;
+                    
+                    DLOGI(TAG, "Bitcoin data fetched successfully");
+                    
+                    // Alerts are evaluated in the first configured currency
+                    if (price_table_get(&price_table, API_ASSET_INDEX, 0, &price, &change)) {
+                        alerts_process_sample(price);
+                    }
+                    display_current_price();
+                } else {
+                    ESP_LOGE(TAG, "Unexpected API response: %s", http_response);
+                    display_error("Parse Error");
+                }
             } else {
-                ESP_LOGE(TAG, "HTTP request failed with status %d", status_code);
+                DLOGE(TAG, "HTTP request failed with status %d", status_code);
                 display_error("HTTP Error");
             }
         } else {
-            ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+            DLOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
             display_error("Request Failed");
         }
         
@@ -434,7 +656,7 @@ static void fetch_bitcoin_data(void)
 // WiFi initialization
 static void wifi_init_sta(void)
 {
-    wifi_event_group = xEventGroupCreate();
+    wifi_event_group = xEventGroupCreateStatic(&wifi_event_group_struct);
     
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
@@ -456,15 +678,6 @@ static void wifi_init_sta(void)
                                                       NULL,
                                                       &instance_got_ip));
     
-    // Load WiFi credentials from NVS or use defaults
-    char ssid[33] = {0};  // 32 chars + null terminator
-    char password[65] = {0};  // 64 chars + null terminator
-    
-    if (wifi_config_load_from_nvs(ssid, password) != ESP_OK) {
-        wifi_config_set_defaults(ssid, password);
-        ESP_LOGW(TAG, "Using default WiFi credentials. Configure via NVS for production.");
-    }
-    
     wifi_config_t wifi_config = {
         .sta = {
             .ssid = "",
@@ -472,101 +685,183 @@ static void wifi_init_sta(void)
         },
     };
     
-    // Copy credentials to WiFi config (safe string copy)
-    strncpy((char*)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid) - 1);
-    strncpy((char*)wifi_config.sta.password, password, sizeof(wifi_config.sta.password) - 1);
+    // Copy credentials from the settings store (safe string copy, the console may be editing them)
+    const settings_t *settings = settings_lock();
+    strncpy((char*)wifi_config.sta.ssid, settings->wifi_ssid, sizeof(wifi_config.sta.ssid) - 1);
+    strncpy((char*)wifi_config.sta.password, settings->wifi_password, sizeof(wifi_config.sta.password) - 1);
+    settings_unlock(false);
     
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
     
-    ESP_LOGI(TAG, "WiFi initialized with SSID: %s", ssid);
+    ESP_LOGI(TAG, "WiFi initialized with SSID: %s", (const char *)wifi_config.sta.ssid);
 }
 
-// WiFi configuration functions
+// Alert functions
 
-// Load WiFi credentials from NVS
-static esp_err_t wifi_config_load_from_nvs(char *ssid, char *password)
+// Copy rules from the settings and compile them into the engine table (settings locked by the caller)
+static void alerts_init(void)
 {
-    nvs_handle_t nvs_handle;
-    esp_err_t err;
+    const settings_t *settings = settings_get();
+    
+    alert_rule_count = settings->alert_rule_count;
+    memcpy(alert_rules, settings->alert_rules, alert_rule_count * sizeof(alert_rule_t));
+    strcpy(alert_asset_id, feed_asset_id);
+    alert_currency = currencies[0];
+    
+    int compiled = alert_engine_compile(&alert_engine, alert_rules, alert_rule_count);
+    for (size_t i = 0; i < alert_rule_count; i++) {
+        if (!alert_rule_fits_history(&alert_rules[i], settings->fetch_interval_s)) {
+            ESP_LOGW(TAG, "Alert rule %d: window exceeds the %u min sample history", (int)i,
+                     (unsigned)(alert_history_span_s(settings->fetch_interval_s) / 60));
+        }
+    }
+    ESP_LOGI(TAG, "Alert engine ready: %d of %d rules active", compiled, (int)alert_rule_count);
+}
+
+// Feed a new price sample to the alert engine and signal fired rules
+static void alerts_process_sample(price_t price)
+{
+    alert_event_t events[ALERT_MAX_EVENTS];
+    uint32_t now_s = (uint32_t)(esp_timer_get_time() / 1000000);
     
-    // Open NVS namespace
-    err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGI(TAG, "NVS namespace not found, using defaults");
-        return ESP_ERR_NOT_FOUND;
+    int fired = alert_engine_update(&alert_engine, now_s, price, events, ALERT_MAX_EVENTS);
+    
+    // Banner lasts until the next sample
+    alert_banner[0] = '\0';
+    
+    for (int i = 0; i < fired; i++) {
+        DLOGI(TAG, "Alert rule %d fired", events[i].rule_index);
+        
+        // Most recent LED pattern wins
+        if (events[i].led_pattern != ALERT_LED_NONE) {
+            led_alert_repeats = LED_PATTERN_REPEATS;
+            led_alert_pattern = events[i].led_pattern;
+        }
+        
+        if (events[i].flags & ALERT_FLAG_BANNER) {
+            alert_format_banner(&events[i], alert_banner, sizeof(alert_banner));
+        }
+    }
+}
+
+// Format the on-screen banner text for a fired alert
+static void alert_format_banner(const alert_event_t *event, char *buf, size_t len)
+{
+    const alert_rule_t *rule = &alert_rules[event->rule_index];
+    const char *symbol = feed_asset_symbol[0] ? feed_asset_symbol : feed_asset_id;
+    
+    switch (event->type) {
+        case ALERT_RULE_PRICE_ABOVE:
+        case ALERT_RULE_PRICE_BELOW: {
+            char level[24];
+            currency_format_price(level, sizeof(level), rule->level, currencies[0]);
+            snprintf(buf, len, "%s %s %s", symbol, event->type == ALERT_RULE_PRICE_ABOVE ? "ABOVE" : "BELOW", level);
+            break;
+        }
+        case ALERT_RULE_PCT_MOVE:
+            snprintf(buf, len, "%s %c%d.%02d%% IN %dM", symbol, event->value < 0 ? '-' : '+',
+                     abs(event->value) / 100, abs(event->value) % 100, (int)(rule->window_s / 60));
+            break;
+        case ALERT_RULE_EMA_CROSS:
+            snprintf(buf, len, "EMA%d/%d CROSS %s", rule->fast, rule->slow, event->value > 0 ? "UP" : "DOWN");
+            break;
+        default:
+            buf[0] = '\0';
+            break;
     }
+}
+
+// Currency functions
+
+// Resolve the configured currency set and build the batched API URL (settings locked by the caller).
+// The asset is copied so the main task parses and labels with the id the URL was built for.
+static void currencies_init(void)
+{
+    const settings_t *settings = settings_get();
     
-    // Load SSID
-    size_t ssid_len = 32;
-    err = nvs_get_str(nvs_handle, NVS_KEY_SSID, ssid, &ssid_len);
-    if (err != ESP_OK) {
-        ESP_LOGI(TAG, "SSID not found in NVS, using default");
-        nvs_close(nvs_handle);
-        return ESP_ERR_NOT_FOUND;
+    strcpy(feed_asset_id, settings->asset_id);
+    strcpy(feed_asset_symbol, settings->asset_symbol);
+    
+    currency_count = currency_parse_list(settings->currencies, currencies, PRICE_TABLE_MAX_CURRENCIES);
+    if (currency_count == 0) {
+        settings_t defaults;
+        settings_set_defaults(&defaults);
+        ESP_LOGW(TAG, "No valid currencies in '%s', using defaults", settings->currencies);
+        currency_count = currency_parse_list(defaults.currencies, currencies, PRICE_TABLE_MAX_CURRENCIES);
     }
+    display_currency = settings->display_currency < currency_count ? settings->display_currency : 0;
     
-    // Load password
-    size_t pass_len = 64;
-    err = nvs_get_str(nvs_handle, NVS_KEY_PASS, password, &pass_len);
-    if (err != ESP_OK) {
-        ESP_LOGI(TAG, "Password not found in NVS, using default");
-        nvs_close(nvs_handle);
-        return ESP_ERR_NOT_FOUND;
+    // ids=bitcoin&vs_currencies=usd,eur,gbp
+    size_t pos = snprintf(api_url, sizeof(api_url), "%s%s%s", API_URL_BASE, feed_asset_id, API_URL_CURRENCIES);
+    for (size_t i = 0; i < currency_count; i++) {
+        pos += snprintf(api_url + pos, sizeof(api_url) - pos, "%s%s", i ? "," : "", currencies[i]->code);
     }
+    snprintf(api_url + pos, sizeof(api_url) - pos, "%s", API_URL_SUFFIX);
     
-    nvs_close(nvs_handle);
-    ESP_LOGI(TAG, "WiFi credentials loaded from NVS");
-    return ESP_OK;
+    ESP_LOGI(TAG, "%d currencies configured", (int)currency_count);
 }
 
-// Save WiFi credentials to NVS
-static esp_err_t wifi_config_save_to_nvs(const char *ssid, const char *password)
+// Switch to the next configured currency and redraw from cached prices
+static void currency_switch_next(void)
 {
-    nvs_handle_t nvs_handle;
-    esp_err_t err;
+    display_currency = (display_currency + 1) % currency_count;
+    DLOGI(TAG, "Display currency: %s", currencies[display_currency]->code);
+    display_current_price();
     
-    // Open NVS namespace for writing
-    err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to open NVS namespace: %s", esp_err_to_name(err));
-        return err;
-    }
+    // Remembered across reboots; quick repeated presses coalesce into one write
+    settings_lock()->display_currency = display_currency;
+    settings_unlock(true);
+}
+
+// Render the cached price for the current display currency
+static void display_current_price(void)
+{
+    price_t price;
+    bp_t change;
     
-    // Save SSID
-    err = nvs_set_str(nvs_handle, NVS_KEY_SSID, ssid);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to save SSID: %s", esp_err_to_name(err));
-        nvs_close(nvs_handle);
-        return err;
+    if (!price_table_get(&price_table, API_ASSET_INDEX, display_currency, &price, &change)) {
+        display_message("No Data", currencies[display_currency]->code);
+        return;
     }
     
-    // Save password
-    err = nvs_set_str(nvs_handle, NVS_KEY_PASS, password);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to save password: %s", esp_err_to_name(err));
-        nvs_close(nvs_handle);
-        return err;
-    }
+    display_bitcoin_data(price, change, currencies[display_currency]);
+}
+
+// Settings functions
+
+// Asset or currency set changed: rebuild the URL and refetch right away
+static void settings_apply_feed(void)
+{
+    settings_lock();
+    currencies_init();
     
-    // Commit changes
-    err = nvs_commit(nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to commit NVS: %s", esp_err_to_name(err));
-        nvs_close(nvs_handle);
-        return err;
+    // Alert history and levels belong to one asset in the first currency
+    if (strcmp(alert_asset_id, feed_asset_id) != 0 || alert_currency != currencies[0]) {
+        alerts_init();
     }
+    settings_unlock(false);
     
-    nvs_close(nvs_handle);
-    ESP_LOGI(TAG, "WiFi credentials saved to NVS");
-    return ESP_OK;
+    // Cached columns no longer match the currency set
+    memset(&price_table, 0, sizeof(price_table));
+    last_fetch_time = 0;
+    ESP_LOGI(TAG, "Price feed changed, refetching");
 }
 
-// Set default WiFi credentials
-static void wifi_config_set_defaults(char *ssid, char *password)
+// Alert rules changed: recompile the engine
+static void settings_apply_rules(void)
 {
-    strcpy(ssid, WIFI_SSID_DEFAULT);
-    strcpy(password, WIFI_PASS_DEFAULT);
-    ESP_LOGI(TAG, "Using default WiFi credentials");
-} 
\ No newline at end of file
+    settings_lock();
+    alerts_init();
+    settings_unlock(false);
+}
+
+// Console callback (console task) - hand the change to the main task
+static void console_settings_changed(console_change_t change)
+{
+    ui_event_t event = change == CONSOLE_CHANGE_FEED ? UI_EVENT_FEED_CHANGED : UI_EVENT_RULES_CHANGED;
+    if (xQueueSend(ui_event_queue, &event, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "UI event queue full, settings change not applied");
+    }
+}
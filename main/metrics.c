@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "metrics.h"
+#include "dlog.h"
+
+static const char *TAG = "METRICS";
+
+typedef struct {
+    TaskHandle_t handle;
+    const char *name;
+    uint32_t stack_size;
+} metrics_task_t;
+
+static metrics_task_t tasks[METRICS_MAX_TASKS];
+static int task_count = 0;
+
+typedef struct {
+    const char *name;
+    const char *json;
+} metrics_section_t;
+
+static metrics_section_t sections[METRICS_MAX_SECTIONS];
+static int section_count = 0;
+
+// Free heap around fetches
+static uint32_t fetch_count = 0;
+static uint32_t fetch_free_before;
+static uint32_t fetch_free_first;
+static int32_t fetch_delta;
+static int32_t fetch_drift;
+
+void metrics_register_task(TaskHandle_t handle, const char *name, uint32_t stack_size)
+{
+    if (handle == NULL || task_count >= METRICS_MAX_TASKS) {
+        return;
+    }
+    tasks[task_count].handle = handle;
+    tasks[task_count].name = name;
+    tasks[task_count].stack_size = stack_size;
+    task_count++;
+}
+
+void metrics_add_section(const char *name, const char *json)
+{
+    if (section_count >= METRICS_MAX_SECTIONS) {
+        return;
+    }
+    sections[section_count].name = name;
+    sections[section_count].json = json;
+    section_count++;
+}
+
+void metrics_fetch_begin(void)
+{
+    fetch_free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+}
+
+void metrics_fetch_end(void)
+{
+    uint32_t free_after = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    if (fetch_count++ == 0) {
+        fetch_free_first = free_after;
+    }
+    fetch_delta = (int32_t)(free_after - fetch_free_before);
+    fetch_drift = (int32_t)(fetch_free_first - free_after);
+}
+
+void metrics_get_heap(metrics_heap_t *heap)
+{
+    heap->free_bytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    heap->min_free_bytes = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    heap->largest_free_block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+}
+
+void metrics_report(void)
+{
+    static char line[1024];
+    metrics_heap_t heap;
+    int pos;
+
+    metrics_get_heap(&heap);
+
+    // Fragmentation: share of free memory not usable as one block
+    unsigned frag_pct = heap.free_bytes ? 100 - (unsigned)((uint64_t)heap.largest_free_block * 100 / heap.free_bytes) : 0;
+
+    pos = snprintf(line, sizeof(line),
+                   "{\"heap_free\":%u,\"heap_min\":%u,\"heap_largest\":%u,\"heap_frag_pct\":%u,"
+                   "\"fetches\":%u,\"fetch_heap_delta\":%d,\"fetch_heap_drift\":%d,\"log_dropped\":%u,\"stack_free\":{",
+                   (unsigned)heap.free_bytes, (unsigned)heap.min_free_bytes,
+                   (unsigned)heap.largest_free_block, frag_pct, (unsigned)fetch_count, (int)fetch_delta,
+                   (int)fetch_drift, (unsigned)dlog_dropped());
+
+    for (int i = 0; i < task_count && pos < (int)sizeof(line); i++) {
+        // High-water mark is the minimum unused stack (bytes on ESP-IDF)
+        pos += snprintf(line + pos, sizeof(line) - pos, "%s\"%s\":[%u,%u]", i ? "," : "",
+                        tasks[i].name, (unsigned)uxTaskGetStackHighWaterMark(tasks[i].handle),
+                        (unsigned)tasks[i].stack_size);
+    }
+    if (pos < (int)sizeof(line)) {
+        pos += snprintf(line + pos, sizeof(line) - pos, "}");
+    }
+    for (int i = 0; i < section_count && pos < (int)sizeof(line); i++) {
+        pos += snprintf(line + pos, sizeof(line) - pos, ",\"%s\":%s", sections[i].name, sections[i].json);
+    }
+    if (pos < (int)sizeof(line)) {
+        snprintf(line + pos, sizeof(line) - pos, "}");
+    }
+
+    ESP_LOGI(TAG, "METRICS %s", line);
+
+    if (heap.min_free_bytes < METRICS_LOW_HEAP_BYTES) {
+        ESP_LOGW(TAG, "Heap low-water mark %u bytes", (unsigned)heap.min_free_bytes);
+    }
+    if (fetch_drift > METRICS_FETCH_DRIFT_BYTES) {
+        ESP_LOGW(TAG, "Free heap after fetch %d bytes below the first fetch", (int)fetch_drift);
+    }
+}
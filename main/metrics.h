@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Runtime memory telemetry: heap headroom, fragmentation and task stack watermarks
+#define METRICS_MAX_TASKS 6
+#define METRICS_MAX_SECTIONS 2
+#define METRICS_LOW_HEAP_BYTES 16384  // Warn when the heap low-water mark drops below this
+#define METRICS_FETCH_DRIFT_BYTES 4096 // Warn when free heap after a fetch falls this far below the first one
+
+typedef struct {
+    uint32_t free_bytes;
+    uint32_t min_free_bytes;       // Low-water mark since boot
+    uint32_t largest_free_block;
+} metrics_heap_t;
+
+// Register a task for stack high-water mark reporting (stack_size in bytes)
+void metrics_register_task(TaskHandle_t handle, const char *name, uint32_t stack_size);
+
+void metrics_get_heap(metrics_heap_t *heap);
+
+// Per-fetch heap tracking around the HTTP/TLS path. Free heap is sampled before and after
+// every fetch; "fetch_heap_delta" is the change over the last fetch and "fetch_heap_drift"
+// how far free heap after the latest fetch is below free heap after the first one.
+void metrics_fetch_begin(void);
+void metrics_fetch_end(void);
+
+// Attach a pre-formatted JSON value to every report as "<name>":<json>.
+// Both strings must stay valid; the contents are re-read on each report.
+void metrics_add_section(const char *name, const char *json);
+
+// Log one "METRICS {...}" JSON line with heap and stack figures and any sections
+void metrics_report(void);
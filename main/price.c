@@ -0,0 +1,248 @@
+#include <stdbool.h>
+#include <string.h>
+#include "price.h"
+
+// Powers of ten that fit in int64
+static const uint64_t pow10_u64[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+    100000000000000000ull, 1000000000000000000ull
+};
+
+#define POW10_MAX 18
+#define MANTISSA_DIGITS_MAX 18
+
+const char *fixed_parse(const char *s, int decimals, int64_t *out)
+{
+    const char *p = s;
+    bool negative = false;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exp10 = decimals;
+
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        p++;
+    }
+    if ((unsigned)(*p - '0') > 9) {
+        return NULL;
+    }
+
+    // Integer digits; past 18 significant digits only the magnitude is kept
+    for (; (unsigned)(*p - '0') <= 9; p++) {
+        if (digits < MANTISSA_DIGITS_MAX) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            digits += (mantissa != 0);
+        } else {
+            exp10++;
+        }
+    }
+    if (*p == '.') {
+        for (p++; (unsigned)(*p - '0') <= 9; p++) {
+            if (digits < MANTISSA_DIGITS_MAX) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                digits += (mantissa != 0);
+                exp10--;
+            }
+        }
+    }
+    if (*p == 'e' || *p == 'E') {
+        const char *q = p + 1;
+        bool exp_negative = false;
+        int exponent = 0;
+
+        if (*q == '-' || *q == '+') {
+            exp_negative = (*q == '-');
+            q++;
+        }
+        if ((unsigned)(*q - '0') <= 9) {
+            for (; (unsigned)(*q - '0') <= 9; q++) {
+                if (exponent < 1000) {
+                    exponent = exponent * 10 + (*q - '0');
+                }
+            }
+            exp10 += exp_negative ? -exponent : exponent;
+            p = q;
+        }
+    }
+
+    // Rescale mantissa * 10^exp10 to an integer
+    uint64_t value;
+    if (mantissa == 0) {
+        value = 0;
+    } else if (exp10 >= 0) {
+        if (exp10 > POW10_MAX || mantissa > (uint64_t)INT64_MAX / pow10_u64[exp10]) {
+            return NULL;
+        }
+        value = mantissa * pow10_u64[exp10];
+    } else if (-exp10 > POW10_MAX) {
+        value = 0;
+    } else {
+        uint64_t divisor = pow10_u64[-exp10];
+        value = mantissa / divisor + (mantissa % divisor >= divisor / 2 + divisor % 2 ? 1 : 0);
+    }
+    if (value > (uint64_t)INT64_MAX) {
+        return NULL;
+    }
+
+    *out = negative ? -(int64_t)value : (int64_t)value;
+    return p;
+}
+
+static const char *skip_ws(const char *p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+        p++;
+    }
+    return p;
+}
+
+// If p points at "<key>" followed by ':', return a pointer to the value
+static const char *match_key(const char *p, const char *key)
+{
+    size_t key_len = strlen(key);
+
+    if (*p != '"' || strncmp(p + 1, key, key_len) != 0 || p[1 + key_len] != '"') {
+        return NULL;
+    }
+    p = skip_ws(p + key_len + 2);
+    return *p == ':' ? skip_ws(p + 1) : NULL;
+}
+
+int json_extract_fixed(const char *json, const char *object, const char *key, int decimals, int64_t *out)
+{
+    const char *p = json;
+    const char *value = NULL;
+
+    // Locate the object
+    while ((p = strchr(p, '"')) != NULL) {
+        value = match_key(p, object);
+        if (value && *value == '{') {
+            break;
+        }
+        p++;
+    }
+    if (!p) {
+        return -1;
+    }
+
+    // Walk its members: "key":value pairs with scalar values
+    p = value + 1;
+    while (*p && *p != '}') {
+        p = skip_ws(p);
+        if (*p == '"') {
+            value = match_key(p, key);
+            if (value) {
+                return fixed_parse(value, decimals, out) ? 0 : -1;
+            }
+            // Skip this key string and its value
+            p = strchr(p + 1, '"');
+            if (!p) {
+                return -1;
+            }
+            p++;
+        }
+        while (*p && *p != ',' && *p != '}') {
+            p++;
+        }
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return -1;
+}
+
+int price_display_decimals(price_t price, int decimals)
+{
+    uint64_t value = price < 0 ? (uint64_t)0 - (uint64_t)price : (uint64_t)price;
+
+    if (value >= (uint64_t)PRICE_SCALE || value == 0) {
+        return decimals;
+    }
+
+    // Leading zeros after the decimal point, then PRICE_SUBUNIT_DIGITS significant digits
+    int leading = 0;
+    while (value < pow10_u64[PRICE_DECIMALS - 1 - leading]) {
+        leading++;
+    }
+    int adaptive = leading + PRICE_SUBUNIT_DIGITS;
+    if (adaptive > PRICE_DECIMALS) {
+        adaptive = PRICE_DECIMALS;
+    }
+    return adaptive > decimals ? adaptive : decimals;
+}
+
+size_t price_format_decimal(char *out, size_t len, price_t price, int decimals, char group, char decimal)
+{
+    char digits[32];
+    int n = 0;
+    const bool negative = price < 0;
+    const uint64_t divisor = pow10_u64[PRICE_DECIMALS - decimals];
+    uint64_t value = negative ? (uint64_t)0 - (uint64_t)price : (uint64_t)price;
+
+    // Round half up to the displayed precision
+    value = (value + divisor / 2) / divisor;
+
+    // Fraction digits, then integer digits with group separators, built in reverse
+    for (int i = 0; i < decimals; i++) {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    }
+    if (decimals > 0) {
+        digits[n++] = decimal;
+    }
+    int grouped = 0;
+    do {
+        if (grouped == 3 && group) {
+            digits[n++] = group;
+            grouped = 0;
+        }
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+        grouped++;
+    } while (value > 0);
+
+    size_t pos = 0;
+    if ((size_t)n + (negative ? 1 : 0) + 1 > len) {
+        return 0;
+    }
+    if (negative) {
+        out[pos++] = '-';
+    }
+    while (n > 0) {
+        out[pos++] = digits[--n];
+    }
+    out[pos] = '\0';
+    return pos;
+}
+
+size_t price_format_percent(char *out, size_t len, bp_t change)
+{
+    char digits[16];
+    int n = 0;
+    uint32_t value = change < 0 ? (uint32_t)0 - (uint32_t)change : (uint32_t)change;
+
+    // "%" and two fraction digits, then the integer part, built in reverse
+    digits[n++] = '%';
+    digits[n++] = (char)('0' + value % 10);
+    value /= 10;
+    digits[n++] = (char)('0' + value % 10);
+    value /= 10;
+    digits[n++] = '.';
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    digits[n++] = change < 0 ? '-' : '+';
+
+    if ((size_t)n + 1 > len) {
+        return 0;
+    }
+    size_t pos = 0;
+    while (n > 0) {
+        out[pos++] = digits[--n];
+    }
+    out[pos] = '\0';
+    return pos;
+}
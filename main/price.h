@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-point price representation
+// Prices are carried as signed 64-bit integers scaled by PRICE_SCALE (1e-8 units),
+// so every asset from sub-cent tokens to BTC fits without floating point:
+// 10^8 * 10^8 = 10^16 < INT64_MAX (9.2 * 10^18).
+typedef int64_t price_t;
+
+#define PRICE_SCALE 100000000LL
+#define PRICE_DECIMALS 8
+
+// Whole units to price_t (e.g. PRICE_FROM_INT(65000) == $65,000.00000000)
+#define PRICE_FROM_INT(x) ((price_t)(x) * PRICE_SCALE)
+
+// Percentages are carried in basis points (1 bp = 0.01%)
+typedef int32_t bp_t;
+
+// Significant digits shown for prices below one unit (0.00012345 -> 0.0001235)
+#define PRICE_SUBUNIT_DIGITS 4
+
+// Parse a JSON number directly into an integer with `decimals` fraction digits,
+// rounding half away from zero. Accepts sign, fraction and exponent ("1.2e-05").
+// Returns a pointer past the number, or NULL if there is no number or it overflows.
+const char *fixed_parse(const char *s, int decimals, int64_t *out);
+
+// Find "<object>":{ ... "<key>":<number> ... } in a flat JSON response and parse
+// the number with `decimals` fraction digits. Returns 0 on success, -1 if not found.
+int json_extract_fixed(const char *json, const char *object, const char *key, int decimals, int64_t *out);
+
+// Fraction digits to show: `decimals` for prices >= 1, otherwise enough for
+// PRICE_SUBUNIT_DIGITS significant digits (at most PRICE_DECIMALS).
+int price_display_decimals(price_t price, int decimals);
+
+// Format a price with `decimals` fraction digits (rounded half up), a thousands
+// separator (0 for none) and a decimal separator. Output is a glyph string (see
+// font.h). Returns the length, or 0 if out is too small.
+size_t price_format_decimal(char *out, size_t len, price_t price, int decimals, char group, char decimal);
+
+// Format basis points as a signed percentage ("+1.23%", "-0.05%")
+size_t price_format_percent(char *out, size_t len, bp_t change);
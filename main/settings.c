@@ -0,0 +1,332 @@
+#include <stddef.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "nvs.h"
+#include "settings.h"
+
+static const char *TAG = "SETTINGS";
+
+#define SETTINGS_NAMESPACE "settings"
+#define SETTINGS_KEY "config"
+
+// Defaults for a fresh device
+#define WIFI_SSID_DEFAULT "Your_WiFi_SSID"
+#define WIFI_PASS_DEFAULT "Your_WiFi_Password"
+#define ASSET_ID_DEFAULT "bitcoin"
+#define ASSET_SYMBOL_DEFAULT "BTC"
+#define CURRENCIES_DEFAULT "usd,eur,gbp"
+#define FETCH_INTERVAL_DEFAULT_S 600    // 10 minutes
+#define METRICS_INTERVAL_DEFAULT_S 300  // 5 minutes
+#define FETCH_INTERVAL_MIN_S 60         // Stay well inside the API rate limit
+
+// Legacy per-key NVS entries (firmware before the settings blob)
+#define LEGACY_WIFI_NAMESPACE "wifi_config"
+#define LEGACY_KEY_SSID "ssid"
+#define LEGACY_KEY_PASS "password"
+#define LEGACY_ALERTS_NAMESPACE "alerts"
+#define LEGACY_KEY_ALERT_RULES "rules"
+#define LEGACY_DISPLAY_NAMESPACE "display"
+#define LEGACY_KEY_CURRENCIES "currencies"
+
+// Stored blob: header followed by the settings payload
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;        // Payload size written by that firmware
+    uint32_t crc;         // CRC32 of the payload
+} settings_header_t;
+
+typedef struct {
+    settings_header_t header;
+    settings_t payload;
+} settings_blob_t;
+
+static const alert_rule_t default_alert_rules[] = {
+    // 3% rise within an hour
+    { .type = ALERT_RULE_PCT_MOVE, .flags = ALERT_FLAG_ENABLED | ALERT_FLAG_BANNER,
+      .led_pattern = ALERT_LED_FAST, .level = 300, .window_s = 3600 },
+    // 3% drop within an hour
+    { .type = ALERT_RULE_PCT_MOVE, .flags = ALERT_FLAG_ENABLED | ALERT_FLAG_BANNER,
+      .led_pattern = ALERT_LED_FAST, .level = -300, .window_s = 3600 },
+    // EMA(12) / EMA(26) crossover, either direction
+    { .type = ALERT_RULE_EMA_CROSS, .flags = ALERT_FLAG_ENABLED | ALERT_FLAG_BANNER,
+      .led_pattern = ALERT_LED_DOUBLE, .fast = 12, .slow = 26 },
+};
+
+static settings_t settings;
+static settings_blob_t blob;          // Staging buffer for NVS reads and writes
+static StaticSemaphore_t settings_mutex_struct;
+static SemaphoreHandle_t settings_mutex;
+
+// Save scheduling
+static bool dirty = false;
+static int64_t first_change_us = 0;
+static int64_t last_change_us = 0;
+static uint32_t saved_crc = 0;
+
+static uint32_t settings_crc(const settings_t *payload, size_t size)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)payload, size);
+}
+
+// Copy with guaranteed termination
+static void copy_string(char *dst, size_t len, const char *src)
+{
+    strncpy(dst, src, len - 1);
+    dst[len - 1] = '\0';
+}
+
+void settings_set_defaults(settings_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    copy_string(s->wifi_ssid, sizeof(s->wifi_ssid), WIFI_SSID_DEFAULT);
+    copy_string(s->wifi_password, sizeof(s->wifi_password), WIFI_PASS_DEFAULT);
+    copy_string(s->asset_id, sizeof(s->asset_id), ASSET_ID_DEFAULT);
+    copy_string(s->asset_symbol, sizeof(s->asset_symbol), ASSET_SYMBOL_DEFAULT);
+    copy_string(s->currencies, sizeof(s->currencies), CURRENCIES_DEFAULT);
+    s->fetch_interval_s = FETCH_INTERVAL_DEFAULT_S;
+    s->metrics_interval_s = METRICS_INTERVAL_DEFAULT_S;
+    memcpy(s->alert_rules, default_alert_rules, sizeof(default_alert_rules));
+    s->alert_rule_count = sizeof(default_alert_rules) / sizeof(default_alert_rules[0]);
+}
+
+// Repair values a corrupt or hand-edited blob could carry
+static void settings_sanitize(settings_t *s)
+{
+    s->wifi_ssid[sizeof(s->wifi_ssid) - 1] = '\0';
+    s->wifi_password[sizeof(s->wifi_password) - 1] = '\0';
+    s->asset_id[sizeof(s->asset_id) - 1] = '\0';
+    s->asset_symbol[sizeof(s->asset_symbol) - 1] = '\0';
+    s->currencies[sizeof(s->currencies) - 1] = '\0';
+
+    if (s->asset_id[0] == '\0') {
+        copy_string(s->asset_id, sizeof(s->asset_id), ASSET_ID_DEFAULT);
+    }
+    if (s->alert_rule_count > ALERT_MAX_RULES) {
+        s->alert_rule_count = ALERT_MAX_RULES;
+    }
+    if (s->fetch_interval_s < FETCH_INTERVAL_MIN_S) {
+        s->fetch_interval_s = FETCH_INTERVAL_MIN_S;
+    }
+    if (s->metrics_interval_s == 0) {
+        s->metrics_interval_s = METRICS_INTERVAL_DEFAULT_S;
+    }
+}
+
+// Read and validate the settings blob. Shorter payloads from older versions are
+// laid over the defaults; per-version conversions go in the switch below.
+static esp_err_t settings_load_blob(settings_t *out)
+{
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(SETTINGS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    size_t len = sizeof(blob);
+    err = nvs_get_blob(nvs_handle, SETTINGS_KEY, &blob, &len);
+    nvs_close(nvs_handle);
+    if (err != ESP_OK) {
+        return err == ESP_ERR_NVS_INVALID_LENGTH ? ESP_ERR_INVALID_VERSION : ESP_ERR_NOT_FOUND;
+    }
+
+    const settings_header_t *h = &blob.header;
+    if (len < sizeof(*h) || h->magic != SETTINGS_MAGIC || h->size != len - sizeof(*h)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (h->version > SETTINGS_VERSION || h->size > sizeof(settings_t)) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (settings_crc(&blob.payload, h->size) != h->crc) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    settings_set_defaults(out);
+    memcpy(out, &blob.payload, h->size);
+
+    switch (h->version) {
+        case SETTINGS_VERSION:
+        default:
+            break;
+    }
+
+    ESP_LOGI(TAG, "Loaded settings v%d (%d bytes)", h->version, h->size);
+    return ESP_OK;
+}
+
+// Build settings from the per-key entries of older firmware
+static bool settings_load_legacy(settings_t *out)
+{
+    nvs_handle_t nvs_handle;
+    bool found = false;
+
+    if (nvs_open(LEGACY_WIFI_NAMESPACE, NVS_READONLY, &nvs_handle) == ESP_OK) {
+        char ssid[sizeof(out->wifi_ssid)];
+        char password[sizeof(out->wifi_password)];
+        size_t ssid_len = sizeof(ssid);
+        size_t pass_len = sizeof(password);
+
+        if (nvs_get_str(nvs_handle, LEGACY_KEY_SSID, ssid, &ssid_len) == ESP_OK &&
+            nvs_get_str(nvs_handle, LEGACY_KEY_PASS, password, &pass_len) == ESP_OK) {
+            copy_string(out->wifi_ssid, sizeof(out->wifi_ssid), ssid);
+            copy_string(out->wifi_password, sizeof(out->wifi_password), password);
+            found = true;
+        }
+        nvs_close(nvs_handle);
+    }
+
+    if (nvs_open(LEGACY_ALERTS_NAMESPACE, NVS_READONLY, &nvs_handle) == ESP_OK) {
+        size_t blob_len = sizeof(out->alert_rules);
+        if (nvs_get_blob(nvs_handle, LEGACY_KEY_ALERT_RULES, out->alert_rules, &blob_len) == ESP_OK &&
+            blob_len % sizeof(alert_rule_t) == 0) {
+            out->alert_rule_count = blob_len / sizeof(alert_rule_t);
+            found = true;
+        } else {
+            memcpy(out->alert_rules, default_alert_rules, sizeof(default_alert_rules));
+        }
+        nvs_close(nvs_handle);
+    }
+
+    if (nvs_open(LEGACY_DISPLAY_NAMESPACE, NVS_READONLY, &nvs_handle) == ESP_OK) {
+        size_t list_len = sizeof(out->currencies);
+        if (nvs_get_str(nvs_handle, LEGACY_KEY_CURRENCIES, out->currencies, &list_len) == ESP_OK) {
+            found = true;
+        } else {
+            copy_string(out->currencies, sizeof(out->currencies), CURRENCIES_DEFAULT);
+        }
+        nvs_close(nvs_handle);
+    }
+
+    return found;
+}
+
+// Remove the legacy entries once they live in the blob
+static void settings_erase_legacy(void)
+{
+    static const char *const namespaces[] = {
+        LEGACY_WIFI_NAMESPACE, LEGACY_ALERTS_NAMESPACE, LEGACY_DISPLAY_NAMESPACE,
+    };
+    nvs_handle_t nvs_handle;
+
+    for (size_t i = 0; i < sizeof(namespaces) / sizeof(namespaces[0]); i++) {
+        if (nvs_open(namespaces[i], NVS_READWRITE, &nvs_handle) == ESP_OK) {
+            nvs_erase_all(nvs_handle);
+            nvs_commit(nvs_handle);
+            nvs_close(nvs_handle);
+        }
+    }
+}
+
+esp_err_t settings_init(void)
+{
+    settings_mutex = xSemaphoreCreateMutexStatic(&settings_mutex_struct);
+
+    esp_err_t err = settings_load_blob(&settings);
+    if (err == ESP_OK) {
+        settings_sanitize(&settings);
+        saved_crc = settings_crc(&settings, sizeof(settings));
+        return ESP_OK;
+    }
+
+    if (err != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "Stored settings rejected (%s), using defaults", esp_err_to_name(err));
+    }
+
+    settings_set_defaults(&settings);
+    bool migrated = err == ESP_ERR_NOT_FOUND && settings_load_legacy(&settings);
+    settings_sanitize(&settings);
+
+    if (!migrated) {
+        // Defaults are not written until something changes
+        return err == ESP_ERR_NOT_FOUND ? ESP_OK : err;
+    }
+
+    ESP_LOGI(TAG, "Migrating legacy NVS keys to settings v%d", SETTINGS_VERSION);
+    dirty = true;
+    err = settings_flush();
+    if (err == ESP_OK) {
+        settings_erase_legacy();
+    }
+    return err;
+}
+
+const settings_t *settings_get(void)
+{
+    return &settings;
+}
+
+settings_t *settings_lock(void)
+{
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    return &settings;
+}
+
+void settings_unlock(bool changed)
+{
+    if (changed) {
+        int64_t now = esp_timer_get_time();
+        if (!dirty) {
+            first_change_us = now;
+            dirty = true;
+        }
+        last_change_us = now;
+    }
+    xSemaphoreGive(settings_mutex);
+}
+
+void settings_poll(int64_t now_us)
+{
+    if (dirty && (now_us - last_change_us >= SETTINGS_SAVE_DEBOUNCE_US ||
+                  now_us - first_change_us >= SETTINGS_SAVE_MAX_DELAY_US)) {
+        settings_flush();
+    }
+}
+
+esp_err_t settings_flush(void)
+{
+    esp_err_t err = ESP_OK;
+
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    if (!dirty) {
+        xSemaphoreGive(settings_mutex);
+        return ESP_OK;
+    }
+    dirty = false;
+
+    uint32_t crc = settings_crc(&settings, sizeof(settings));
+    if (crc != saved_crc) {
+        blob.header.magic = SETTINGS_MAGIC;
+        blob.header.version = SETTINGS_VERSION;
+        blob.header.size = sizeof(settings);
+        blob.header.crc = crc;
+        memcpy(&blob.payload, &settings, sizeof(settings));
+
+        nvs_handle_t nvs_handle;
+        err = nvs_open(SETTINGS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+        if (err == ESP_OK) {
+            err = nvs_set_blob(nvs_handle, SETTINGS_KEY, &blob, sizeof(blob));
+            if (err == ESP_OK) {
+                err = nvs_commit(nvs_handle);
+            }
+            nvs_close(nvs_handle);
+        }
+
+        if (err == ESP_OK) {
+            saved_crc = crc;
+            ESP_LOGI(TAG, "Settings saved (%d bytes)", (int)sizeof(blob));
+        } else {
+            // Retry after the next debounce window
+            ESP_LOGE(TAG, "Failed to save settings: %s", esp_err_to_name(err));
+            dirty = true;
+            first_change_us = last_change_us = esp_timer_get_time();
+        }
+    }
+    // else: edits cancelled out (e.g. cycled back to the saved currency)
+
+    xSemaphoreGive(settings_mutex);
+    return err;
+}
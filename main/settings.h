@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "alerts.h"
+
+// Persistent settings: one versioned, CRC-protected blob in NVS, read once at boot
+// and kept in RAM. Changes are saved after SETTINGS_SAVE_DEBOUNCE_US of quiet, or
+// at most SETTINGS_SAVE_MAX_DELAY_US after the first unsaved change, so bursts of
+// edits (button presses, console commands) become a single flash write.
+#define SETTINGS_MAGIC 0x46435442  // "BTCF"
+#define SETTINGS_VERSION 1
+#define SETTINGS_SAVE_DEBOUNCE_US 2000000LL
+#define SETTINGS_SAVE_MAX_DELAY_US 30000000LL
+
+// Layout rule: new fields are only ever appended. Blobs written by older firmware
+// are shorter; the missing tail keeps its defaults (see settings.c).
+typedef struct {
+    char wifi_ssid[33];
+    char wifi_password[65];
+    char asset_id[32];            // CoinGecko coin id, e.g. "bitcoin"
+    char asset_symbol[8];         // Short label for banners, e.g. "BTC"
+    char currencies[64];          // Comma separated; the first one drives the alerts
+    uint8_t display_currency;     // Index into the currency list
+    uint8_t alert_rule_count;
+    uint16_t reserved;
+    uint32_t fetch_interval_s;    // Scheduler: seconds between price fetches
+    uint32_t metrics_interval_s;  // Scheduler: seconds between METRICS lines
+    alert_rule_t alert_rules[ALERT_MAX_RULES];
+} settings_t;
+
+// Load settings (one NVS read). Falls back to the legacy per-key entries, then to
+// defaults; migrated settings are written back as a blob immediately.
+esp_err_t settings_init(void);
+
+// Read-only view of the live settings. The console edits them from its own task, so
+// other tasks take settings_lock() to read strings or the rule list, or copy what
+// they keep using (main.c keeps the asset its API URL was built for). Only the
+// 32-bit interval fields may be read without the lock.
+const settings_t *settings_get(void);
+
+// Defaults for a fresh device
+void settings_set_defaults(settings_t *settings);
+
+// Edit the live settings: settings_lock() takes the mutex and returns the struct,
+// settings_unlock(true) releases it and schedules a debounced save.
+settings_t *settings_lock(void);
+void settings_unlock(bool changed);
+
+// Write pending changes once the debounce window has passed. Call periodically.
+void settings_poll(int64_t now_us);
+
+// Write pending changes now (e.g. before a restart)
+esp_err_t settings_flush(void);
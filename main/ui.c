@@ -0,0 +1,82 @@
+#include <string.h>
+#include "ui.h"
+
+// Bitcoin Icon (24x24px)
+static const unsigned char bitcoin_icon[] = {
+    0x00, 0x7e, 0x00, 0x03, 0xff, 0xc0, 0x07, 0x81, 0xe0, 0x0e, 0x00, 0x70, 0x18, 0x28, 0x18, 0x30,
+    0x28, 0x0c, 0x70, 0xfc, 0x0e, 0x60, 0xfe, 0x06, 0x60, 0xc7, 0x06, 0xc0, 0xc3, 0x03, 0xc0, 0xc7,
+    0x03, 0xc0, 0xfe, 0x03, 0xc0, 0xff, 0x03, 0xc0, 0xc3, 0x83, 0xc0, 0xc1, 0x83, 0xc0, 0x60, 0xc3, 0x86,
+    0x60, 0xff, 0x06, 0x70, 0xfe, 0x0e, 0x30, 0x28, 0x0c, 0x18, 0x28, 0x18, 0x0e, 0x00, 0x70, 0x07,
+    0x81, 0xe0, 0x03, 0xff, 0xc0, 0x00, 0x7e, 0x00
+};
+
+#define ICON_SIZE 24
+#define BANNER_HEIGHT 9
+
+// Icon for the asset, NULL if there is none
+static const unsigned char *asset_icon(const char *asset_id)
+{
+    return strcmp(asset_id, "bitcoin") == 0 ? bitcoin_icon : NULL;
+}
+
+void ui_print_center(framebuffer_t *fb, const char *text, int x, int y, int scale)
+{
+    size_t len = strlen(text);
+    fb_draw_glyphs(fb, x - fb_glyphs_width(len, scale) / 2, y, (const uint8_t *)text, len, scale, true);
+}
+
+void ui_draw_welcome(framebuffer_t *fb, const char *asset_id)
+{
+    const unsigned char *icon = asset_icon(asset_id);
+
+    fb_clear(fb);
+    if (icon) {
+        fb_draw_bitmap(fb, (FB_WIDTH - ICON_SIZE) / 2, 4, icon, ICON_SIZE, ICON_SIZE);
+    }
+    ui_print_center(fb, asset_id, FB_WIDTH / 2, 36, 1);
+    ui_print_center(fb, "PRICE TRACKER", FB_WIDTH / 2, 48, 1);
+}
+
+void ui_draw_message(framebuffer_t *fb, const char *title, const char *message)
+{
+    fb_clear(fb);
+    ui_print_center(fb, title, FB_WIDTH / 2, 12, 2);
+    ui_print_center(fb, message, FB_WIDTH / 2, 40, 1);
+}
+
+void ui_draw_standby(framebuffer_t *fb)
+{
+    fb_clear(fb);
+    ui_print_center(fb, "STANDBY", FB_WIDTH / 2, 25, 2);
+}
+
+void ui_draw_price(framebuffer_t *fb, const char *asset_id, price_t price, bp_t change_24h,
+                   const currency_t *currency, const char *banner, char *price_text, size_t price_text_len)
+{
+    const unsigned char *icon = asset_icon(asset_id);
+    const int label_x = icon ? 30 : 0;
+    char change_text[16] = "24H ";
+    size_t len;
+
+    fb_clear(fb);
+    if (icon) {
+        fb_draw_bitmap(fb, 0, 0, icon, ICON_SIZE, ICON_SIZE);
+    }
+    fb_draw_glyphs(fb, label_x, 4, (const uint8_t *)asset_id, strlen(asset_id), 1, true);
+    fb_draw_glyphs(fb, label_x, 14, (const uint8_t *)currency->code, strlen(currency->code), 1, true);
+
+    // Price in large digits when it fits the screen width
+    len = currency_format_price(price_text, price_text_len, price, currency);
+    ui_print_center(fb, price_text, FB_WIDTH / 2, 28, fb_glyphs_width(len, 2) <= FB_WIDTH ? 2 : 1);
+
+    price_format_percent(change_text + 4, sizeof(change_text) - 4, change_24h);
+    ui_print_center(fb, change_text, FB_WIDTH / 2, 45, 1);
+
+    // Alert banner as inverted text on the bottom line
+    if (banner && banner[0]) {
+        len = strlen(banner);
+        fb_fill_rect(fb, 0, FB_HEIGHT - BANNER_HEIGHT, FB_WIDTH, BANNER_HEIGHT, true);
+        fb_draw_glyphs(fb, (FB_WIDTH - fb_glyphs_width(len, 1)) / 2, FB_HEIGHT - BANNER_HEIGHT + 1,
+                       (const uint8_t *)banner, len, 1, false);
+    }
+}
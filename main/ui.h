@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include "framebuffer.h"
+#include "currency.h"
+#include "price.h"
+
+// Screen layouts, drawn into a framebuffer (sending it to the panel is up to the caller).
+// asset_id is the CoinGecko coin id; it is shown as the asset label, with the coin icon
+// for assets that have one (bitcoin).
+
+void ui_draw_welcome(framebuffer_t *fb, const char *asset_id);
+void ui_draw_message(framebuffer_t *fb, const char *title, const char *message);
+void ui_draw_standby(framebuffer_t *fb);
+
+// Price screen: icon, asset, currency, large price, 24h change and an optional inverted
+// banner line. The formatted price glyph string is returned in price_text.
+void ui_draw_price(framebuffer_t *fb, const char *asset_id, price_t price, bp_t change_24h,
+                   const currency_t *currency, const char *banner, char *price_text, size_t price_text_len);
+
+// Draw a glyph string centered on x, top edge at y
+void ui_print_center(framebuffer_t *fb, const char *text, int x, int y, int scale);
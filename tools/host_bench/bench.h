@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "price.h"
+
+// Allocation counters, fed by the --wrap=malloc/calloc/realloc/free hooks in host_bench.c.
+// Only calls made from the benchmarked modules are routed through them.
+typedef struct {
+    unsigned long allocs;
+    unsigned long frees;
+    long live;
+    size_t bytes;
+} alloc_stats_t;
+
+extern alloc_stats_t alloc_stats;
+
+// Monotonic clock in nanoseconds
+uint64_t now_ns(void);
+
+// Scripted price sequence line: "<seconds> <price>", price as a decimal number.
+// Returns false for comments ('#'), blank and malformed lines.
+bool scripted_line_parse(const char *line, uint32_t *t, price_t *price);
+
+// Kernel regression suite (regress.c): host_bench regress <corpus-dir> [options]
+int regress_main(int argc, char **argv);
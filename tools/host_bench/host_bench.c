@@ -0,0 +1,562 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "price.h"
+#include "alerts.h"
+#include "currency.h"
+#include "framebuffer.h"
+#include "ui.h"
+#include "bench.h"
+
+// Benchmark Configuration
+#define BENCH_TICKS 200000
+#define BENCH_MAX_TICKS 1000000
+#define BENCH_RULE_SETS 4
+#define BENCH_FORMAT_VALUES 4096
+#define BENCH_FORMAT_ROUNDS 200
+#define SOAK_CYCLES_DEFAULT 100000
+
+typedef struct {
+    uint32_t t;
+    price_t price;
+} tick_t;
+
+static tick_t ticks[BENCH_MAX_TICKS];
+static size_t tick_count = 0;
+
+// Allocation counters (see bench.h)
+alloc_stats_t alloc_stats;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size)
+{
+    alloc_stats.allocs++;
+    alloc_stats.live++;
+    alloc_stats.bytes += size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    alloc_stats.allocs++;
+    alloc_stats.live++;
+    alloc_stats.bytes += n * size;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        alloc_stats.live++;
+    }
+    alloc_stats.allocs++;
+    alloc_stats.bytes += size;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+    if (ptr) {
+        alloc_stats.frees++;
+        alloc_stats.live--;
+    }
+    __real_free(ptr);
+}
+
+uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Deterministic xorshift so runs are comparable
+static uint32_t rng_state = 0x12345678;
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Random-walk tick stream around $65,000, one tick every 10s, steps of up to +/-0.2%
+static void ticks_generate(size_t count)
+{
+    price_t price = PRICE_FROM_INT(65000);
+
+    for (size_t i = 0; i < count; i++) {
+        int32_t step_bp = (int32_t)(rng_next() % 41) - 20;  // -0.20% .. +0.20%
+        price += price / 10000 * step_bp;
+        ticks[i].t = (uint32_t)(i * 10);
+        ticks[i].price = price;
+    }
+    tick_count = count;
+}
+
+bool scripted_line_parse(const char *line, uint32_t *t, price_t *price)
+{
+    char *end;
+
+    if (line[0] == '#') {
+        return false;
+    }
+    unsigned long seconds = strtoul(line, &end, 10);
+    if (end == line || *end != ' ') {
+        return false;
+    }
+    const char *rest = fixed_parse(end + 1, PRICE_DECIMALS, price);
+    if (!rest) {
+        return false;
+    }
+    while (*rest == ' ' || *rest == '\t' || *rest == '\r' || *rest == '\n') {
+        rest++;
+    }
+    if (*rest != '\0') {
+        return false;
+    }
+    *t = (uint32_t)seconds;
+    return true;
+}
+
+// Replay a recorded or scripted stream (same format as corpus/prices.txt)
+static int ticks_load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[128];
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    tick_count = 0;
+    while (tick_count < BENCH_MAX_TICKS && fgets(line, sizeof(line), f)) {
+        if (scripted_line_parse(line, &ticks[tick_count].t, &ticks[tick_count].price)) {
+            tick_count++;
+        }
+    }
+    fclose(f);
+    return tick_count > 0 ? 0 : -1;
+}
+
+// Build a rule set with an even mix of all rule types
+static size_t rules_build(alert_rule_t *rules, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        alert_rule_t *rule = &rules[i];
+        memset(rule, 0, sizeof(*rule));
+        rule->flags = ALERT_FLAG_ENABLED | ALERT_FLAG_BANNER;
+        rule->led_pattern = ALERT_LED_FAST;
+        rule->type = (uint8_t)(i % ALERT_RULE_TYPE_COUNT);
+
+        switch (rule->type) {
+            case ALERT_RULE_PRICE_ABOVE:
+                rule->level = PRICE_FROM_INT(65000 + 500 * (int64_t)i);
+                break;
+            case ALERT_RULE_PRICE_BELOW:
+                rule->level = PRICE_FROM_INT(65000 - 500 * (int64_t)i);
+                break;
+            case ALERT_RULE_PCT_MOVE:
+                rule->level = (i & 4) ? -(int64_t)(50 + i * 10) : (int64_t)(50 + i * 10);
+                rule->window_s = 600 + (uint32_t)i * 300;
+                break;
+            case ALERT_RULE_EMA_CROSS:
+                rule->fast = (uint16_t)(5 + i);
+                rule->slow = (uint16_t)(20 + 2 * i);
+                break;
+        }
+    }
+    return count;
+}
+
+static void bench_alerts(void)
+{
+    static const size_t rule_counts[BENCH_RULE_SETS] = { 1, 4, 8, ALERT_MAX_RULES };
+    static alert_engine_t engine;
+    alert_rule_t rules[ALERT_MAX_RULES];
+    alert_event_t events[ALERT_MAX_EVENTS];
+
+    printf("%-8s %10s %10s %12s %10s\n", "rules", "ticks", "events", "ns/tick", "ns/rule");
+
+    for (int s = 0; s < BENCH_RULE_SETS; s++) {
+        size_t n = rules_build(rules, rule_counts[s]);
+        unsigned long total_events = 0;
+
+        alert_engine_compile(&engine, rules, n);
+
+        uint64_t start = now_ns();
+        for (size_t i = 0; i < tick_count; i++) {
+            total_events += (unsigned long)alert_engine_update(&engine, ticks[i].t, ticks[i].price,
+                                                               events, ALERT_MAX_EVENTS);
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        double ns_tick = (double)elapsed / (double)tick_count;
+        printf("%-8zu %10zu %10lu %12.1f %10.2f\n", n, tick_count, total_events, ns_tick, ns_tick / (double)n);
+    }
+}
+
+// Reference display precision, derived from the %e exponent rather than price.c's digit table:
+// below one unit show PRICE_SUBUNIT_DIGITS significant digits, capped at PRICE_DECIMALS
+static int reference_display_decimals(price_t price, int decimals)
+{
+    unsigned long long value = (unsigned long long)(price < 0 ? -price : price);
+    char sci[32];
+
+    if (value == 0 || value >= (unsigned long long)PRICE_SCALE) {
+        return decimals;
+    }
+
+    // Exact in a double below 2^53; enough mantissa digits that %e cannot round up a decade
+    snprintf(sci, sizeof(sci), "%.17e", (double)value);
+    int exponent = atoi(strchr(sci, 'e') + 1) - PRICE_DECIMALS;
+    int adaptive = -exponent - 1 + PRICE_SUBUNIT_DIGITS;
+    if (adaptive > PRICE_DECIMALS) {
+        adaptive = PRICE_DECIMALS;
+    }
+    return adaptive > decimals ? adaptive : decimals;
+}
+
+// Reference formatter: the straightforward snprintf version of currency_format_price
+static void reference_format_price(char *out, size_t len, price_t price, const currency_t *currency)
+{
+    int decimals = reference_display_decimals(price, currency->decimals);
+    unsigned long long value = (unsigned long long)(price < 0 ? -price : price);
+    unsigned long long divisor = 1;
+    char plain[24];
+    char grouped[40];
+    size_t g = 0;
+
+    for (int i = decimals; i < PRICE_DECIMALS; i++) {
+        divisor *= 10;
+    }
+    value = (value + divisor / 2) / divisor;
+
+    unsigned long long unit = 1;
+    for (int i = 0; i < decimals; i++) {
+        unit *= 10;
+    }
+    int int_len = snprintf(plain, sizeof(plain), "%llu", value / unit);
+    for (int i = 0; i < int_len; i++) {
+        if (i > 0 && (int_len - i) % 3 == 0 && currency->group) {
+            grouped[g++] = currency->group;
+        }
+        grouped[g++] = plain[i];
+    }
+    if (decimals > 0) {
+        grouped[g++] = currency->decimal;
+        g += (size_t)snprintf(grouped + g, sizeof(grouped) - g, "%0*llu", decimals, value % unit);
+    }
+    grouped[g] = '\0';
+    snprintf(out, len, "%s%s%s", price < 0 ? "-" : "", currency->symbol, grouped);
+}
+
+// Prices across the whole price_t range, from 1e-8 units up to 10^8 units
+static price_t format_values[BENCH_FORMAT_VALUES];
+
+static void format_values_generate(void)
+{
+    static const price_t edge[] = {
+        0, 1, 5, 49, 50, 99999, 100000, 99995000, 99999999, PRICE_SCALE, PRICE_SCALE - 1,
+        PRICE_FROM_INT(999), 99950000000LL, PRICE_FROM_INT(1000), PRICE_FROM_INT(65000) + 12345678,
+        -PRICE_FROM_INT(1234) - 50000000, PRICE_FROM_INT(100000000),
+    };
+    size_t n = sizeof(edge) / sizeof(edge[0]);
+
+    memcpy(format_values, edge, sizeof(edge));
+    for (size_t i = n; i < BENCH_FORMAT_VALUES; i++) {
+        uint64_t magnitude = 1;
+        for (uint32_t d = rng_next() % 17; d > 0; d--) {
+            magnitude *= 10;
+        }
+        format_values[i] = (price_t)(((uint64_t)rng_next() << 32 | rng_next()) % magnitude);
+    }
+}
+
+// Check the fast paths against references. Returns the number of mismatches.
+static int verify_format(void)
+{
+    static const char *codes[] = { "usd", "eur", "gbp", "jpy", "chf", "cad", "aud" };
+    char ours[64];
+    char ref[64];
+    int errors = 0;
+
+    for (size_t c = 0; c < sizeof(codes) / sizeof(codes[0]); c++) {
+        const currency_t *currency = currency_find(codes[c]);
+        for (size_t i = 0; i < BENCH_FORMAT_VALUES; i++) {
+            currency_format_price(ours, sizeof(ours), format_values[i], currency);
+            reference_format_price(ref, sizeof(ref), format_values[i], currency);
+            if (strcmp(ours, ref) != 0 && errors++ < 10) {
+                fprintf(stderr, "format mismatch %s %lld: '%s' != '%s'\n", codes[c],
+                        (long long)format_values[i], ours, ref);
+            }
+        }
+    }
+
+    // Sub-unit precision edge cases with fixed expected output
+    static const struct { const char *code; price_t price; const char *expected; } fixed[] = {
+        { "usd", 12345, "$0.0001235" },            // 0.00012345, rounds half up to 4 digits
+        { "usd", -12345, "-$0.0001235" },
+        { "usd", 99999000, "$1.0000" },            // 0.99999, precision picked before rounding
+        { "usd", 99990000, "$0.9999" },
+        { "usd", 1, "$0.00000001" },               // 1e-8, capped at PRICE_DECIMALS
+        { "usd", 99995, "$0.0010000" },            // 0.00099995 carries into the next decade
+        { "usd", PRICE_SCALE, "$1.00" },
+        { "jpy", 50000000, "\x82" "0.5000" },
+        { "jpy", PRICE_FROM_INT(1234), "\x82" "1,234" },
+    };
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        const currency_t *currency = currency_find(fixed[i].code);
+        currency_format_price(ours, sizeof(ours), fixed[i].price, currency);
+        reference_format_price(ref, sizeof(ref), fixed[i].price, currency);
+        if ((strcmp(ours, fixed[i].expected) != 0 || strcmp(ref, fixed[i].expected) != 0) && errors++ < 10) {
+            fprintf(stderr, "sub-unit mismatch %s %lld: '%s' / reference '%s', expected '%s'\n", fixed[i].code,
+                    (long long)fixed[i].price, ours, ref, fixed[i].expected);
+        }
+    }
+
+    for (bp_t bp = -100000; bp <= 100000; bp++) {
+        price_format_percent(ours, sizeof(ours), bp);
+        snprintf(ref, sizeof(ref), "%+.2f%%", bp / 100.0);
+        if (strcmp(ours, ref) != 0 && errors++ < 10) {
+            fprintf(stderr, "percent mismatch %d: '%s' != '%s'\n", (int)bp, ours, ref);
+        }
+    }
+
+    // Parsing must round-trip every printed value exactly
+    for (size_t i = 0; i < BENCH_FORMAT_VALUES; i++) {
+        price_t value = format_values[i];
+        price_t parsed = 0;
+        price_t magnitude = value < 0 ? -value : value;
+        snprintf(ref, sizeof(ref), "%s%lld.%08lld", value < 0 ? "-" : "",
+                 (long long)(magnitude / PRICE_SCALE), (long long)(magnitude % PRICE_SCALE));
+        if ((!fixed_parse(ref, PRICE_DECIMALS, &parsed) || parsed != value) && errors++ < 10) {
+            fprintf(stderr, "parse mismatch '%s': %lld\n", ref, (long long)parsed);
+        }
+    }
+
+    // Exponent and rounding forms seen in API responses
+    static const struct { const char *text; int decimals; int64_t expected; } cases[] = {
+        { "1.234e-05", PRICE_DECIMALS, 1234 },
+        { "6.5E4", PRICE_DECIMALS, PRICE_FROM_INT(65000) },
+        { "65000", PRICE_DECIMALS, PRICE_FROM_INT(65000) },
+        { "0.000000005", PRICE_DECIMALS, 1 },
+        { "0.000000004999", PRICE_DECIMALS, 0 },
+        { "-1.23456", 2, -123 },
+        { "-1.235", 2, -124 },
+        { "2.3456789012345678901234", 2, 235 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        int64_t parsed = 0;
+        if ((!fixed_parse(cases[i].text, cases[i].decimals, &parsed) || parsed != cases[i].expected) &&
+            errors++ < 10) {
+            fprintf(stderr, "parse mismatch '%s': %lld != %lld\n", cases[i].text,
+                    (long long)parsed, (long long)cases[i].expected);
+        }
+    }
+
+    // A response missing a currency (omitted or truncated) must not leave the previous price valid
+    static price_table_t table;
+    const currency_t *table_currencies[3] = { currency_find("usd"), currency_find("eur"), currency_find("gbp") };
+    price_t price;
+    bp_t change;
+    price_table_update_from_json(&table, "{\"bitcoin\":{\"usd\":65000,\"eur\":60000,\"gbp\":51000}}",
+                                 "bitcoin", 0, table_currencies, 3);
+    bool updated = price_table_update_from_json(&table, "{\"bitcoin\":{\"usd\":66000,\"gbp\":52",
+                                                "bitcoin", 0, table_currencies, 3);
+    if ((!updated || !price_table_get(&table, 0, 0, &price, &change) || price != PRICE_FROM_INT(66000) ||
+         price_table_get(&table, 0, 1, &price, &change)) && errors++ < 10) {
+        fprintf(stderr, "price table kept a currency missing from the latest response\n");
+    }
+
+    return errors;
+}
+
+static void bench_format(void)
+{
+    const currency_t *usd = currency_find("usd");
+    char buf[64];
+    volatile size_t sink = 0;
+    uint64_t start;
+    const double ops = (double)BENCH_FORMAT_ROUNDS * BENCH_FORMAT_VALUES;
+
+    printf("%-28s %10s\n", "formatter", "ns/op");
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_FORMAT_ROUNDS; r++) {
+        for (size_t i = 0; i < BENCH_FORMAT_VALUES; i++) {
+            sink += currency_format_price(buf, sizeof(buf), format_values[i], usd);
+        }
+    }
+    printf("%-28s %10.1f\n", "currency_format_price", (double)(now_ns() - start) / ops);
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_FORMAT_ROUNDS; r++) {
+        for (size_t i = 0; i < BENCH_FORMAT_VALUES; i++) {
+            reference_format_price(buf, sizeof(buf), format_values[i], usd);
+            sink += (size_t)buf[0];
+        }
+    }
+    printf("%-28s %10.1f\n", "snprintf reference", (double)(now_ns() - start) / ops);
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_FORMAT_ROUNDS; r++) {
+        for (size_t i = 0; i < BENCH_FORMAT_VALUES; i++) {
+            sink += (size_t)snprintf(buf, sizeof(buf), "%.2f", (double)format_values[i] / PRICE_SCALE);
+        }
+    }
+    printf("%-28s %10.1f\n", "snprintf(\"%.2f\", double)", (double)(now_ns() - start) / ops);
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_FORMAT_ROUNDS; r++) {
+        for (size_t i = 0; i < BENCH_FORMAT_VALUES; i++) {
+            sink += price_format_percent(buf, sizeof(buf), (bp_t)(format_values[i] % 100000));
+        }
+    }
+    printf("%-28s %10.1f\n", "price_format_percent", (double)(now_ns() - start) / ops);
+
+    start = now_ns();
+    for (int r = 0; r < BENCH_FORMAT_ROUNDS; r++) {
+        for (size_t i = 0; i < BENCH_FORMAT_VALUES; i++) {
+            sink += (size_t)snprintf(buf, sizeof(buf), "%+.2f%%", (double)(format_values[i] % 100000) / 100.0);
+        }
+    }
+    printf("%-28s %10.1f\n", "snprintf(\"%+.2f%%\", double)", (double)(now_ns() - start) / ops);
+    (void)sink;
+}
+
+// Display writer that only counts I2C bytes
+static int count_write(void *ctx, const uint8_t *bytes, size_t len)
+{
+    (void)bytes;
+    *(size_t *)ctx += len;
+    return 0;
+}
+
+// Render-path soak: run everything after the HTTP response arrives (parse -> price table ->
+// alerts -> render -> flush) many times on the same static state. These modules are meant
+// to be allocation-free, so any allocation fails the run. The HTTP/TLS client is not
+// exercised here; its heap use is tracked on the device (fetch_heap_* in METRICS).
+static int soak(unsigned long cycles)
+{
+    static const char *codes[] = { "usd", "eur", "gbp" };
+    static alert_engine_t engine;
+    static framebuffer_t fb;
+    static price_table_t table;
+    const currency_t *currencies[3];
+    alert_rule_t rules[ALERT_MAX_RULES];
+    alert_event_t events[ALERT_MAX_EVENTS];
+    char response[512];
+    char price_text[32];
+    size_t i2c_bytes = 0;
+    unsigned long fired = 0;
+
+    for (int i = 0; i < 3; i++) {
+        currencies[i] = currency_find(codes[i]);
+    }
+    alert_engine_compile(&engine, rules, rules_build(rules, ALERT_MAX_RULES));
+    ticks_generate(BENCH_TICKS);
+
+    const alloc_stats_t before = alloc_stats;
+    uint64_t start = now_ns();
+
+    for (unsigned long c = 0; c < cycles; c++) {
+        const tick_t *tick = &ticks[c % tick_count];
+        long long whole = tick->price / PRICE_SCALE;
+        long long cents = tick->price % PRICE_SCALE / 1000000;
+        int change = (int)(c % 2001) - 1000;
+
+        // What the API would have returned for this tick
+        snprintf(response, sizeof(response),
+                 "{\"bitcoin\":{\"usd\":%lld.%02lld,\"usd_24h_change\":%d.%02d,"
+                 "\"eur\":%lld.%02lld,\"eur_24h_change\":%d.%02d,"
+                 "\"gbp\":%lld.%02lld,\"gbp_24h_change\":%d.%02d}}",
+                 whole, cents, change / 100, abs(change % 100),
+                 whole * 92 / 100, cents, change / 100, abs(change % 100),
+                 whole * 79 / 100, cents, change / 100, abs(change % 100));
+
+        price_t price;
+        bp_t change_bp;
+        if (!price_table_update_from_json(&table, response, "bitcoin", 0, currencies, 3) ||
+            !price_table_get(&table, 0, (int)(c % 3), &price, &change_bp)) {
+            fprintf(stderr, "soak: parse failed at cycle %lu: %s\n", c, response);
+            return 1;
+        }
+        fired += (unsigned long)alert_engine_update(&engine, (uint32_t)(c * 600), table.price[0][0],
+                                                    events, ALERT_MAX_EVENTS);
+        ui_draw_price(&fb, "bitcoin", price, change_bp, currencies[c % 3], fired & 1 ? "ALERT" : "",
+                      price_text, sizeof(price_text));
+        fb_flush(&fb, count_write, &i2c_bytes);
+    }
+
+    uint64_t elapsed = now_ns() - start;
+    const unsigned long allocs = alloc_stats.allocs - before.allocs;
+    const long leaked = alloc_stats.live - before.live;
+
+    printf("%-10s %12s %12s %12s %10s %10s\n", "cycles", "us/cycle", "i2c B/cycle", "allocs", "leaked", "alerts");
+    printf("%-10lu %12.2f %12.1f %12lu %10ld %10lu\n", cycles, (double)elapsed / 1000.0 / (double)cycles,
+           (double)i2c_bytes / (double)cycles, allocs, leaked, fired);
+
+    if (allocs != 0 || leaked != 0) {
+        fprintf(stderr, "soak: render path allocated %lu times (%ld live)\n", allocs, leaked);
+        return 1;
+    }
+    return 0;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [all|alerts|format] [ticks-file]\n"
+                    "       %s soak [cycles]\n"
+                    "       %s regress <corpus-dir> [--baseline file] [--out file] [--tolerance pct] [--timing] [--update]\n",
+            argv0, argv0, argv0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *mode = argc > 1 ? argv[1] : "all";
+    const bool all = strcmp(mode, "all") == 0;
+
+    if (strcmp(mode, "soak") == 0) {
+        return soak(argc > 2 ? strtoul(argv[2], NULL, 10) : SOAK_CYCLES_DEFAULT);
+    }
+    if (strcmp(mode, "regress") == 0) {
+        return regress_main(argc - 1, argv + 1);
+    }
+    if (!all && strcmp(mode, "alerts") != 0 && strcmp(mode, "format") != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (all || strcmp(mode, "format") == 0) {
+        format_values_generate();
+        int errors = verify_format();
+        if (errors) {
+            fprintf(stderr, "%d formatter/parser mismatches\n", errors);
+            return 1;
+        }
+        printf("formatter and parser match reference\n\n");
+        bench_format();
+        printf("\n");
+    }
+
+    if (all || strcmp(mode, "alerts") == 0) {
+        if (argc > 2) {
+            if (ticks_load(argv[2]) != 0) {
+                fprintf(stderr, "No ticks loaded from %s\n", argv[2]);
+                return 1;
+            }
+        } else {
+            ticks_generate(BENCH_TICKS);
+        }
+        bench_alerts();
+    }
+
+    return 0;
+}
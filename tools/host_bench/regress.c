@@ -0,0 +1,477 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "price.h"
+#include "currency.h"
+#include "font.h"
+#include "framebuffer.h"
+#include "ui.h"
+#include "bench.h"
+
+// Kernel regression suite: times the device hot paths on fixed corpora, writes the
+// results as JSON and compares them with a stored baseline. A kernel fails when it
+// allocates more, sends more I2C bytes or produces different output (checksum) than
+// the baseline. These checks are deterministic. Timing depends on the machine the
+// baseline was recorded on, so a slowdown beyond the tolerance only fails with --timing.
+
+#define REGRESS_MAX_RESPONSES 64
+#define REGRESS_RESPONSE_MAX 2048
+#define REGRESS_MAX_PRICES 1024
+#define REGRESS_FRAMES 64
+#define REGRESS_REPS 15
+#define REGRESS_MIN_REP_NS 5000000ull    // Repeat passes for at least 5 ms per rep
+#define REGRESS_RETRIES 2                // Re-measure a kernel that looks slower before failing
+#define REGRESS_TOLERANCE_PCT 50
+#define REGRESS_JSON_MAX 4096
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+typedef struct {
+    const char *name;
+    // One pass over the corpus. Returns the number of operations; output is
+    // hashed into *hash when it is not NULL (untimed checksum pass).
+    size_t (*run)(uint32_t *hash);
+} kernel_t;
+
+typedef struct {
+    double ns_per_op;
+    double bytes_per_op;     // Heap bytes allocated
+    double allocs_per_op;
+    double io_bytes_per_op;  // Bytes sent to the SSD1306
+    uint32_t checksum;
+} result_t;
+
+// Corpora
+static char responses[REGRESS_MAX_RESPONSES][REGRESS_RESPONSE_MAX];
+static size_t response_count = 0;
+static price_t prices[REGRESS_MAX_PRICES];
+static size_t price_count = 0;
+
+static const char *const assets[] = { "bitcoin", "ethereum" };
+#define ASSET_COUNT (sizeof(assets) / sizeof(assets[0]))
+static const currency_t *currencies[PRICE_TABLE_MAX_CURRENCIES];
+static size_t currency_count = 0;
+
+// Kernel state
+static price_table_t table;
+static framebuffer_t fb;
+static uint8_t frames[REGRESS_FRAMES][FB_PAGES][FB_WIDTH];
+static char texts[REGRESS_MAX_PRICES][32];
+static uint8_t text_lens[REGRESS_MAX_PRICES];
+static uint64_t io_bytes = 0;
+
+static uint32_t fnv(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// 24h change for the n-th scripted price, -10.00% .. +10.00%
+static bp_t scripted_change(size_t n)
+{
+    return (bp_t)((n * 37) % 2001) - 1000;
+}
+
+// Corpus loading
+
+static int load_responses(const char *dir)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/api_responses.jsonl", dir);
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    while (response_count < REGRESS_MAX_RESPONSES &&
+           fgets(responses[response_count], REGRESS_RESPONSE_MAX, f)) {
+        if (responses[response_count][0] == '{') {
+            response_count++;
+        }
+    }
+    fclose(f);
+    return response_count > 0 ? 0 : -1;
+}
+
+// "<seconds> <price>" lines, '#' comments. Prices are parsed exactly with fixed_parse.
+static int load_prices(const char *dir)
+{
+    char path[512];
+    char line[128];
+    uint32_t t;
+    snprintf(path, sizeof(path), "%s/prices.txt", dir);
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    while (price_count < REGRESS_MAX_PRICES && fgets(line, sizeof(line), f)) {
+        if (scripted_line_parse(line, &t, &prices[price_count])) {
+            price_count++;
+        }
+    }
+    fclose(f);
+    return price_count > 0 ? 0 : -1;
+}
+
+// SSD1306 writer: copies each transaction into a TX buffer like the I2C driver would
+static int stream_write(void *ctx, const uint8_t *bytes, size_t len)
+{
+    static uint8_t tx[1 + FB_WIDTH];
+    uint32_t *hash = ctx;
+
+    memcpy(tx, bytes, len < sizeof(tx) ? len : sizeof(tx));
+    io_bytes += len;
+    if (hash) {
+        *hash = fnv(*hash, tx, len);
+    }
+    return 0;
+}
+
+// Kernels
+
+// JSON extraction: every recorded response into the asset x currency table
+static size_t kernel_json_extract(uint32_t *hash)
+{
+    for (size_t r = 0; r < response_count; r++) {
+        for (size_t a = 0; a < ASSET_COUNT; a++) {
+            price_table_update_from_json(&table, responses[r], assets[a], (int)a, currencies, currency_count);
+        }
+        if (hash) {
+            *hash = fnv(*hash, &table, sizeof(table));
+        }
+    }
+    return response_count * ASSET_COUNT;
+}
+
+// Price formatting: every scripted price in every currency, plus the 24h change
+static size_t kernel_price_format(uint32_t *hash)
+{
+    char out[48];
+
+    for (size_t i = 0; i < price_count; i++) {
+        for (size_t c = 0; c < currency_count; c++) {
+            size_t n = currency_format_price(out, sizeof(out), prices[i], currencies[c]);
+            n += price_format_percent(out + n, sizeof(out) - n, scripted_change(i));
+            if (hash) {
+                *hash = fnv(*hash, out, n);
+            }
+        }
+    }
+    return price_count * currency_count;
+}
+
+// Glyph blitting: clear the price line and draw it at scale 2, as the price screen does
+static size_t kernel_glyph_blit(uint32_t *hash)
+{
+    for (size_t i = 0; i < price_count; i++) {
+        size_t len = text_lens[i];
+        int scale = fb_glyphs_width(len, 2) <= FB_WIDTH ? 2 : 1;
+        fb_fill_rect(&fb, 0, 28, FB_WIDTH, FONT_HEIGHT * 2, false);
+        fb_draw_glyphs(&fb, 0, 28, (const uint8_t *)texts[i], len, scale, true);
+        if (hash) {
+            *hash = fnv(*hash, fb.pixels, sizeof(fb.pixels));
+        }
+    }
+    return price_count;
+}
+
+// Framebuffer diff: flush consecutive price screens, sending only changed spans
+static size_t kernel_fb_diff(uint32_t *hash)
+{
+    memcpy(fb.shadow, frames[REGRESS_FRAMES - 1], sizeof(fb.shadow));
+    fb.shadow_valid = true;
+
+    for (size_t k = 0; k < REGRESS_FRAMES; k++) {
+        memcpy(fb.pixels, frames[k], sizeof(fb.pixels));
+        fb_flush(&fb, stream_write, hash);
+    }
+    return REGRESS_FRAMES;
+}
+
+// SSD1306 byte stream: full-frame flushes (boot, error recovery)
+static size_t kernel_ssd1306_stream(uint32_t *hash)
+{
+    for (size_t k = 0; k < REGRESS_FRAMES; k++) {
+        memcpy(fb.pixels, frames[k], sizeof(fb.pixels));
+        fb_invalidate(&fb);
+        fb_flush(&fb, stream_write, hash);
+    }
+    return REGRESS_FRAMES;
+}
+
+static const kernel_t kernels[] = {
+    { "json_extract", kernel_json_extract },
+    { "price_format", kernel_price_format },
+    { "glyph_blit", kernel_glyph_blit },
+    { "fb_diff", kernel_fb_diff },
+    { "ssd1306_stream", kernel_ssd1306_stream },
+};
+
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+// Pre-render the inputs the rendering kernels consume
+static void kernels_setup(void)
+{
+    static const char *const codes[] = { "usd", "eur", "gbp", "jpy", "chf", "cad" };
+    char price_text[32];
+
+    for (size_t i = 0; i < sizeof(codes) / sizeof(codes[0]); i++) {
+        currencies[currency_count++] = currency_find(codes[i]);
+    }
+
+    for (size_t i = 0; i < price_count; i++) {
+        text_lens[i] = (uint8_t)currency_format_price(texts[i], sizeof(texts[i]), prices[i], currencies[0]);
+    }
+
+    for (size_t k = 0; k < REGRESS_FRAMES; k++) {
+        size_t i = k * price_count / REGRESS_FRAMES;
+        ui_draw_price(&fb, "bitcoin", prices[i], scripted_change(i), currencies[k % currency_count],
+                      k % 8 == 7 ? "BTC +3.00% IN 60M" : "", price_text, sizeof(price_text));
+        memcpy(frames[k], fb.pixels, sizeof(frames[k]));
+    }
+    fb_clear(&fb);
+}
+
+static int measure(const kernel_t *kernel, result_t *result)
+{
+    uint32_t check = FNV_OFFSET;
+
+    // Warm up, then two checksum passes that must agree
+    kernel->run(NULL);
+    result->checksum = FNV_OFFSET;
+    kernel->run(&result->checksum);
+    kernel->run(&check);
+    if (check != result->checksum) {
+        fprintf(stderr, "%s: output is not deterministic\n", kernel->name);
+        return -1;
+    }
+
+    result->ns_per_op = 0;
+    for (int rep = 0; rep < REGRESS_REPS; rep++) {
+        const alloc_stats_t before = alloc_stats;
+        size_t ops = 0;
+
+        io_bytes = 0;
+        uint64_t start = now_ns();
+        uint64_t elapsed;
+        do {
+            ops += kernel->run(NULL);
+            elapsed = now_ns() - start;
+        } while (elapsed < REGRESS_MIN_REP_NS);
+
+        // Fastest rep: least disturbed by the rest of the machine
+        double ns_per_op = (double)elapsed / (double)ops;
+        if (rep == 0 || ns_per_op < result->ns_per_op) {
+            result->ns_per_op = ns_per_op;
+        }
+        result->allocs_per_op = (double)(alloc_stats.allocs - before.allocs) / (double)ops;
+        result->bytes_per_op = (double)(alloc_stats.bytes - before.bytes) / (double)ops;
+        result->io_bytes_per_op = (double)io_bytes / (double)ops;
+    }
+    return 0;
+}
+
+static size_t results_format_json(const result_t *results, char *buf, size_t len)
+{
+    size_t pos = (size_t)snprintf(buf, len, "{\n  \"version\": 1,\n  \"kernels\": {\n");
+
+    for (size_t i = 0; i < KERNEL_COUNT && pos < len; i++) {
+        const result_t *r = &results[i];
+        pos += (size_t)snprintf(buf + pos, len - pos,
+                                "    \"%s\": {\"ns_per_op\": %.3f, \"bytes_per_op\": %.3f, \"allocs_per_op\": %.3f, "
+                                "\"io_bytes_per_op\": %.3f, \"checksum\": %u}%s\n",
+                                kernels[i].name, r->ns_per_op, r->bytes_per_op, r->allocs_per_op,
+                                r->io_bytes_per_op, (unsigned)r->checksum, i + 1 < KERNEL_COUNT ? "," : "");
+    }
+    if (pos < len) {
+        pos += (size_t)snprintf(buf + pos, len - pos, "  }\n}\n");
+    }
+    return pos < len ? pos : 0;
+}
+
+static int write_file(const char *path, const char *data, size_t len)
+{
+    FILE *f = fopen(path, "w");
+    if (!f || fwrite(data, 1, len, f) != len) {
+        perror(path);
+        if (f) {
+            fclose(f);
+        }
+        return -1;
+    }
+    return fclose(f);
+}
+
+static size_t read_file(const char *path, char *buf, size_t len)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    size_t n = fread(buf, 1, len - 1, f);
+    buf[n] = '\0';
+    fclose(f);
+    return n;
+}
+
+// Metric in thousandths, as stored with three decimals in the baseline
+static int64_t milli(double value)
+{
+    return (int64_t)(value * 1000.0 + 0.5);
+}
+
+typedef struct {
+    int64_t ns, bytes, allocs, io, checksum;
+} baseline_entry_t;
+
+static bool baseline_find(const char *baseline, const char *name, baseline_entry_t *entry)
+{
+    return baseline &&
+           json_extract_fixed(baseline, name, "ns_per_op", 3, &entry->ns) == 0 &&
+           json_extract_fixed(baseline, name, "bytes_per_op", 3, &entry->bytes) == 0 &&
+           json_extract_fixed(baseline, name, "allocs_per_op", 3, &entry->allocs) == 0 &&
+           json_extract_fixed(baseline, name, "io_bytes_per_op", 3, &entry->io) == 0 &&
+           json_extract_fixed(baseline, name, "checksum", 0, &entry->checksum) == 0;
+}
+
+static const char *kernel_status(const result_t *r, const baseline_entry_t *base, int tolerance_pct,
+                                 bool gate_timing)
+{
+    if ((int64_t)r->checksum != base->checksum) {
+        return "FAIL output changed";
+    }
+    if (milli(r->allocs_per_op) > base->allocs || milli(r->bytes_per_op) > base->bytes) {
+        return "FAIL allocates more";
+    }
+    if (milli(r->io_bytes_per_op) > base->io) {
+        return "FAIL more I2C bytes";
+    }
+    if (milli(r->ns_per_op) * 100 > base->ns * (100 + tolerance_pct)) {
+        return gate_timing ? "FAIL slower" : "slower (not gated)";
+    }
+    return "ok";
+}
+
+// Compare against the baseline. Returns the number of failed kernels.
+static int compare(result_t *results, const char *baseline, int tolerance_pct, bool gate_timing)
+{
+    int failures = 0;
+
+    printf("%-16s %10s %10s %8s %10s %10s %10s  %s\n",
+           "kernel", "ns/op", "base", "delta", "bytes/op", "allocs/op", "io B/op", "status");
+
+    for (size_t i = 0; i < KERNEL_COUNT; i++) {
+        const char *name = kernels[i].name;
+        result_t *r = &results[i];
+        baseline_entry_t base;
+        const char *status = baseline ? "FAIL not in baseline" : "no baseline";
+        bool found = baseline_find(baseline, name, &base);
+
+        if (found) {
+            status = kernel_status(r, &base, tolerance_pct, gate_timing);
+
+            // A slowdown must reproduce: keep the best time over a few more measurements
+            for (int retry = 0; retry < REGRESS_RETRIES && strcmp(status, "FAIL slower") == 0; retry++) {
+                result_t again;
+                if (measure(&kernels[i], &again) == 0 && again.ns_per_op < r->ns_per_op) {
+                    r->ns_per_op = again.ns_per_op;
+                }
+                status = kernel_status(r, &base, tolerance_pct, gate_timing);
+            }
+        }
+        failures += strncmp(status, "FAIL", 4) == 0;
+
+        if (found) {
+            double base_ns = (double)base.ns / 1000.0;
+            printf("%-16s %10.1f %10.1f %+7.1f%% %10.1f %10.3f %10.1f  %s\n", name, r->ns_per_op, base_ns,
+                   (r->ns_per_op - base_ns) * 100.0 / base_ns, r->bytes_per_op, r->allocs_per_op,
+                   r->io_bytes_per_op, status);
+        } else {
+            printf("%-16s %10.1f %10s %8s %10.1f %10.3f %10.1f  %s\n", name, r->ns_per_op, "-", "-",
+                   r->bytes_per_op, r->allocs_per_op, r->io_bytes_per_op, status);
+        }
+    }
+    return failures;
+}
+
+int regress_main(int argc, char **argv)
+{
+    static result_t results[KERNEL_COUNT];
+    static char json[REGRESS_JSON_MAX];
+    static char baseline[REGRESS_JSON_MAX];
+    const char *baseline_path = NULL;
+    const char *out_path = NULL;
+    int tolerance_pct = REGRESS_TOLERANCE_PCT;
+    bool gate_timing = false;
+    bool update = false;
+
+    if (argc < 2) {
+        fprintf(stderr, "regress: corpus directory required\n");
+        return 2;
+    }
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance_pct = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--timing") == 0) {
+            gate_timing = true;
+        } else if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else {
+            fprintf(stderr, "regress: unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (load_responses(argv[1]) != 0 || load_prices(argv[1]) != 0) {
+        fprintf(stderr, "regress: no corpus in %s\n", argv[1]);
+        return 2;
+    }
+    kernels_setup();
+    printf("corpus: %zu API responses, %zu scripted prices\n", response_count, price_count);
+
+    for (size_t i = 0; i < KERNEL_COUNT; i++) {
+        if (measure(&kernels[i], &results[i]) != 0) {
+            return 1;
+        }
+    }
+
+    // A named baseline must exist: a missing or renamed file must not pass as "no regressions"
+    bool have_baseline = !update && baseline_path && read_file(baseline_path, baseline, sizeof(baseline)) > 0;
+    if (!update && baseline_path && !have_baseline) {
+        fprintf(stderr, "regress: baseline %s missing or empty\n", baseline_path);
+        return 1;
+    }
+
+    int failures = compare(results, have_baseline ? baseline : NULL, tolerance_pct, gate_timing);
+
+    size_t json_len = results_format_json(results, json, sizeof(json));
+    if (out_path && write_file(out_path, json, json_len) != 0) {
+        return 2;
+    }
+    if (update) {
+        if (!baseline_path || write_file(baseline_path, json, json_len) != 0) {
+            fprintf(stderr, "regress: --update needs a writable --baseline\n");
+            return 2;
+        }
+        printf("baseline written to %s\n", baseline_path);
+        return 0;
+    }
+
+    if (failures) {
+        fprintf(stderr, "regress: %d kernel(s) regressed\n", failures);
+        return 1;
+    }
+    return 0;
+}